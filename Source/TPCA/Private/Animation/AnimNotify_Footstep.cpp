@@ -0,0 +1,102 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "Animation/AnimNotify_Footstep.h"
+#include "Animation/FootstepSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/ExtCharacter.h"
+#include "Kismet/GameplayStatics.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Sound/SoundBase.h"
+
+DECLARE_CYCLE_STAT(TEXT("Char Footstep Notify"), STAT_FootstepNotify, STATGROUP_Character);
+
+UAnimNotify_Footstep::UAnimNotify_Footstep()
+{
+	DefaultSound = nullptr;
+	bRightFoot = false;
+	VolumeMultiplier = 1.f;
+	PitchMultiplier = 1.f;
+	MaxDistance = 2000.f;
+	MaxConcurrent = 16;
+
+#if WITH_EDITORONLY_DATA
+	NotifyColor = FColor(196, 142, 255, 255);
+#endif
+}
+
+FString UAnimNotify_Footstep::GetNotifyName_Implementation() const
+{
+	return bRightFoot ? TEXT("Footstep R") : TEXT("Footstep L");
+}
+
+void UAnimNotify_Footstep::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FootstepNotify);
+
+	UWorld* World = MeshComp ? MeshComp->GetWorld() : nullptr;
+	if (!World)
+		return;
+
+	const AExtCharacter* ExtCharacter = Cast<AExtCharacter>(MeshComp->GetOwner());
+	FName FootName = SocketName;
+	if (FootName.IsNone() && ExtCharacter)
+		FootName = bRightFoot ? ExtCharacter->GetRightFootBoneName() : ExtCharacter->GetLeftFootBoneName();
+
+	const FVector Location = MeshComp->GetSocketLocation(FootName);
+
+	UFootstepSubsystem* FootstepSubsystem = World->GetSubsystem<UFootstepSubsystem>();
+	if (!FootstepSubsystem)
+	{
+		// Animation editor preview, there is no character or floor
+		if (DefaultSound)
+			UGameplayStatics::PlaySoundAtLocation(World, DefaultSound, Location, VolumeMultiplier, PitchMultiplier);
+		return;
+	}
+
+	if (!FootstepSubsystem->ShouldPlayFootstep(Location, MaxDistance, MaxConcurrent))
+		return;
+
+	const ACharacter* Character = Cast<ACharacter>(MeshComp->GetOwner());
+	const UCharacterMovementComponent* Movement = Character ? Character->GetCharacterMovement() : nullptr;
+	if (!Movement || !Movement->IsMovingOnGround() || !Movement->CurrentFloor.IsWalkableFloor())
+		return;
+
+	// The floor sweep does not return physical materials by default so fall back to the body of the floor component
+	const FHitResult& FloorHit = Movement->CurrentFloor.HitResult;
+	const UPhysicalMaterial* PhysMaterial = FloorHit.PhysMaterial.Get();
+	if (!PhysMaterial)
+	{
+		if (const UPrimitiveComponent* FloorComponent = FloorHit.GetComponent())
+		{
+			if (const FBodyInstance* BodyInstance = FloorComponent->GetBodyInstance(FloorHit.BoneName))
+				PhysMaterial = BodyInstance->GetSimplePhysicalMaterial();
+		}
+	}
+
+	FootstepSubsystem->PlayFootstep(GetSoundForMaterial(PhysMaterial), Location, VolumeMultiplier, PitchMultiplier);
+}
+
+USoundBase* UAnimNotify_Footstep::GetSoundForMaterial(const UPhysicalMaterial* PhysMaterial) const
+{
+	if (!PhysMaterial)
+		return DefaultSound;
+
+	if (USoundBase** CachedSound = SoundCache.Find(PhysMaterial))
+		return *CachedSound;
+
+	USoundBase* const* SurfaceSound = SurfaceSounds.Find(PhysMaterial->SurfaceType);
+	USoundBase* Sound = SurfaceSound && *SurfaceSound ? *SurfaceSound : DefaultSound;
+	SoundCache.Add(PhysMaterial, Sound);
+	return Sound;
+}
+
+#if WITH_EDITOR
+void UAnimNotify_Footstep::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	SoundCache.Empty();
+}
+#endif
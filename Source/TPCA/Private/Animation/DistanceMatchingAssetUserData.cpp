@@ -0,0 +1,96 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "Animation/DistanceMatchingAssetUserData.h"
+#include "Animation/AnimSequenceBase.h"
+
+UDistanceMatchingAssetUserData::UDistanceMatchingAssetUserData()
+{
+	TimeStep = 1.f / 30.f;
+	PlayLength = 0.f;
+	DistanceStep = 1.f;
+	TotalDistance = 0.f;
+}
+
+void UDistanceMatchingAssetUserData::Build(const TArray<float>& InDistances, float InTimeStep, float InPlayLength, float InDistanceStep)
+{
+	check(InTimeStep > 0.f);
+	check(InDistanceStep > 0.f);
+
+	TimeStep = InTimeStep;
+	PlayLength = InPlayLength;
+	DistanceStep = InDistanceStep;
+	Distances = InDistances;
+	TotalDistance = Distances.Num() > 0 ? Distances.Last() : 0.f;
+
+	// Invert the distance curve by walking both tables at once. Distances never decrease so this is linear.
+	// The last entry is at the total distance, which is usually not a multiple of DistanceStep
+	const int32 NumTimes = FMath::FloorToInt(TotalDistance / DistanceStep) + 1;
+	const bool bHasPartialStep = TotalDistance > (NumTimes - 1) * DistanceStep;
+	Times.SetNumUninitialized(NumTimes + (bHasPartialStep ? 1 : 0));
+
+	int32 Index = 0;
+	for (int32 TimeIndex = 0; TimeIndex < Times.Num(); ++TimeIndex)
+	{
+		const float Distance = FMath::Min(TimeIndex * DistanceStep, TotalDistance);
+		while (Index < Distances.Num() - 2 && Distances[Index + 1] < Distance)
+			++Index;
+
+		if (Distances.Num() < 2)
+		{
+			Times[TimeIndex] = 0.f;
+		}
+		else
+		{
+			const float Diff = Distances[Index + 1] - Distances[Index];
+			const float Alpha = !FMath::IsNearlyZero(Diff) ? FMath::Clamp((Distance - Distances[Index]) / Diff, 0.f, 1.f) : 0.f;
+			// The last segment ends at PlayLength and can be shorter than TimeStep
+			Times[TimeIndex] = FMath::Lerp(Index * TimeStep, FMath::Min((Index + 1) * TimeStep, PlayLength), Alpha);
+		}
+	}
+}
+
+float UDistanceMatchingAssetUserData::GetTimeFromDistance(float Distance) const
+{
+	return SampleUniform(Times, DistanceStep, TotalDistance, Distance);
+}
+
+float UDistanceMatchingAssetUserData::GetTimeFromDistanceRemaining(float DistanceRemaining) const
+{
+	return SampleUniform(Times, DistanceStep, TotalDistance, TotalDistance - DistanceRemaining);
+}
+
+float UDistanceMatchingAssetUserData::GetDistanceFromTime(float Time) const
+{
+	return SampleUniform(Distances, TimeStep, GetLastSampleTime(), Time);
+}
+
+UDistanceMatchingAssetUserData* UDistanceMatchingAssetUserData::Find(const UAnimSequenceBase* AnimSequence)
+{
+	// GetAssetUserDataOfClass is not const
+	return AnimSequence ? Cast<UDistanceMatchingAssetUserData>(const_cast<UAnimSequenceBase*>(AnimSequence)->GetAssetUserDataOfClass(StaticClass())) : nullptr;
+}
+
+float UDistanceMatchingAssetUserData::GetLastSampleTime() const
+{
+	return PlayLength > 0.f ? PlayLength : FMath::Max(0, Distances.Num() - 1) * TimeStep;
+}
+
+float UDistanceMatchingAssetUserData::SampleUniform(const TArray<float>& Samples, float Step, float LastKey, float Key)
+{
+	const int32 NumSamples = Samples.Num();
+	if (NumSamples == 0)
+		return 0.f;
+
+	if (Key >= LastKey)
+		return Samples.Last();
+
+	const float ClampedKey = FMath::Max(0.f, Key);
+	const int32 Index = FMath::FloorToInt(ClampedKey / Step);
+	if (Index >= NumSamples - 1)
+		return Samples.Last();
+
+	// The last segment ends at LastKey and can be shorter than Step
+	const float SegmentStart = Index * Step;
+	const float SegmentEnd = FMath::Min((Index + 1) * Step, LastKey);
+	return FMath::Lerp(Samples[Index], Samples[Index + 1], (ClampedKey - SegmentStart) / (SegmentEnd - SegmentStart));
+}
@@ -3,6 +3,8 @@
 #include "Animation/ExtCharacterAnimInstance.h"
 #include "Animation/AnimNode_StateMachine.h"
 #include "Animation/BlendSpace.h"
+#include "Animation/DistanceMatchingAssetUserData.h"
+#include "Animation/MontageInterruptPolicyAssetUserData.h"
 #include "GameFramework/ExtCharacter.h"
 #include "GameFramework/ExtCharacterMovementComponent.h"
 #include "Components/CapsuleComponent.h"
@@ -15,12 +17,47 @@
 
 DEFINE_LOG_CATEGORY_STATIC(LogExtCharacterAnimInstance, Log, All);
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Montages Stopped By Movement Mode"), STAT_MontagesStoppedByMovementMode, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Montage Interrupts Filtered"), STAT_MontageInterruptsFiltered, STATGROUP_Anim);
+
 const float UExtCharacterAnimInstance::AngleTolerance = 1e-3f;
 
+const int32 FExtCharacterTurnInPlaceTable::SamplesPerDegree = 4;
+
+static void SampleTurnInPlaceCurve(TArray<float>& OutSamples, const UCurveFloat* Curve, bool bRight, float Range)
+{
+	OutSamples.Reset();
+	if (Curve)
+	{
+		const int32 NumSamples = FMath::RoundToInt(Range) * FExtCharacterTurnInPlaceTable::SamplesPerDegree + 1;
+		OutSamples.SetNumUninitialized(NumSamples);
+		for (int32 Index = 0; Index < NumSamples; ++Index)
+		{
+			const float Angle = (float)Index / FExtCharacterTurnInPlaceTable::SamplesPerDegree;
+			OutSamples[Index] = Curve->GetFloatValue(bRight ? Angle : -Angle);
+		}
+	}
+}
+
+void FExtCharacterTurnInPlaceTable::Build(const UExtCharacterAnimInstance* AnimDefaults)
+{
+	check(AnimDefaults);
+
+	SampleTurnInPlaceCurve(Samples[Normal][false][true], AnimDefaults->GetTurnInPlaceLeftLongCurveNormal(), false, 180.f);
+	SampleTurnInPlaceCurve(Samples[Normal][true][true], AnimDefaults->GetTurnInPlaceRightLongCurveNormal(), true, 180.f);
+	SampleTurnInPlaceCurve(Samples[Normal][false][false], AnimDefaults->GetTurnInPlaceLeftShortCurveNormal(), false, 90.f);
+	SampleTurnInPlaceCurve(Samples[Normal][true][false], AnimDefaults->GetTurnInPlaceRightShortCurveNormal(), true, 90.f);
+	SampleTurnInPlaceCurve(Samples[LeftFootFwd][false][false], AnimDefaults->GetTurnInPlaceLeftCurveLeftFootFwd(), false, 90.f);
+	SampleTurnInPlaceCurve(Samples[LeftFootFwd][true][false], AnimDefaults->GetTurnInPlaceRightCurveLeftFootFwd(), true, 90.f);
+	SampleTurnInPlaceCurve(Samples[Crouched][false][false], AnimDefaults->GetTurnInPlaceLeftCurveCrouched(), false, 90.f);
+	SampleTurnInPlaceCurve(Samples[Crouched][true][false], AnimDefaults->GetTurnInPlaceRightCurveCrouched(), true, 90.f);
+}
+
 UExtCharacterAnimInstance::UExtCharacterAnimInstance()
 {
 	AimOffsetInterpSpeed = 10.0f;
 	AimOffsetResetInterpSpeed = 2.0f;
+	AimOffsetCurrentInterpSpeed = AimOffsetResetInterpSpeed;
 	AimOffsetMaxAngle = 0.0f;
 	AimDistanceDefault = 200.0f;
 	RootBoneResetSpeed = 180.0f;
@@ -53,6 +90,18 @@ UExtCharacterAnimInstance::UExtCharacterAnimInstance()
 	ForceVelocityScale = 10.f;
 
 	SpeedWarpScale = 1.0f;
+
+	bSkipUpdateWhenInputsUnchanged = true;
+	UnchangedInputsCount = 0;
+
+	DefaultMontageInterruptingMovementModes = ~0;
+	FallingMontageInterruptDelay = 0.f;
+	MontageInterruptBlendOutTime = 0.1f;
+	bHasPendingMontageInterrupt = false;
+	MontageInterruptFromMode = MOVE_None;
+	MontageInterruptFromCustomMode = 0;
+	MontageInterruptTime = 0.f;
+	NumMontagesStoppedByMovementMode = 0;
 }
 
 void UExtCharacterAnimInstance::NativeInitializeAnimation()
@@ -78,8 +127,8 @@ void UExtCharacterAnimInstance::NativeInitializeAnimation()
 
 		// Ragdoll Event Handler
 		// Ensure delegate is bound (just once)
-		CharacterOwner->RagdollChangedDelegate.RemoveDynamic(this, &UExtCharacterAnimInstance::HandleRagdollChanged);
-		CharacterOwner->RagdollChangedDelegate.AddDynamic(this, &UExtCharacterAnimInstance::HandleRagdollChanged);
+		CharacterOwner->RagdollChangedNativeDelegate.RemoveAll(this);
+		CharacterOwner->RagdollChangedNativeDelegate.AddUObject(this, &UExtCharacterAnimInstance::HandleRagdollChanged);
 
 		CharacterOwnerMesh = GetSkelMeshComponent();
 		if (IsValid(CharacterOwnerMesh))
@@ -87,9 +136,23 @@ void UExtCharacterAnimInstance::NativeInitializeAnimation()
 			LastCharacterMeshLocation = CharacterOwnerMesh->GetComponentLocation();
 			RootBoneRotation = CharacterOwnerMesh->GetComponentQuat();
 		}
+
+		// Force a full update on the next frame
+		UnchangedInputsCount = 0;
 	}
 }
 
+#if WITH_EDITOR
+
+void UExtCharacterAnimInstance::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	InvalidateTurnInPlaceTable();
+}
+
+#endif
+
 
 /// Every Tick
 
@@ -100,6 +163,19 @@ void UExtCharacterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 		&& IsValid(CharacterOwnerMesh)
 		&& DeltaSeconds > 0.0f)
 	{
+		FExtCharacterAnimInputs Inputs;
+		GatherInputs(Inputs);
+
+		UnchangedInputsCount = (Inputs == LastInputs) ? UnchangedInputsCount + 1 : 0;
+		LastInputs = Inputs;
+
+		if (bSkipUpdateWhenInputsUnchanged && CanSkipDerivedUpdate(Inputs))
+		{
+			NativeUpdateCharacterSettings();
+			NativeUpdateInterpolators(DeltaSeconds);
+			return;
+		}
+
 		LastSpeed = Speed;
 		LastGroundSpeed = GroundSpeed;
 
@@ -169,20 +245,12 @@ void UExtCharacterAnimInstance::NativeUpdateAnimation(float DeltaSeconds)
 		LookDelta = (LookRotation - CharacterRotation).GetNormalized();
 		LookAtActor = CharacterOwner->GetLookAtActor();
 
-		GetUpDelay = CharacterOwner->GetUpDelay;
-
-		UseHeadlook = CharacterOwner->UseHeadlook;
-		UseBodylook = CharacterOwner->UseBodylook;
-		bUseLookInputInMovement = CharacterOwner->bUseLookInputInMovement;
-
 		SetMovementMode(CharacterOwnerMovement->MovementMode, CharacterOwnerMovement->CustomMovementMode);
 		SetCrouched(CharacterOwner->bIsCrouched);
 		SetGait(CharacterOwner->GetGait());
 		SetPerformingGenericAction(CharacterOwner->bIsPerformingGenericAction);
 
-		// Enable Foot IK only if enabled by the character, not ragdoll and moving on ground.
-		bEnableFootIK = CharacterOwner->bEnableFootIK && !bIsRagdoll && (MovementMode == MOVE_Walking || MovementMode == MOVE_NavWalking);
-		bEnableLookIK = CharacterOwner->bEnableLookIK && !bIsRagdoll && (MovementMode == MOVE_Walking || MovementMode == MOVE_NavWalking);
+		NativeUpdateCharacterSettings();
 
 		if (bIsRagdoll)
 		{
@@ -416,6 +484,10 @@ void UExtCharacterAnimInstance::NativeUpdateTurnInPlace(float DeltaSeconds)
 		else if (TurnInPlaceDelta > AngleTolerance)
 			bIsTurningInPlaceRight = true;
 
+		const FExtCharacterTurnInPlaceTable::EStance Stance = bIsCrouched ? FExtCharacterTurnInPlaceTable::Crouched
+			: bIsPerformingGenericAction ? FExtCharacterTurnInPlaceTable::LeftFootFwd
+			: FExtCharacterTurnInPlaceTable::Normal;
+
 		float TargetDeltaRemaining = TurnInPlaceTargetYaw - (RootBoneRotation * CharacterOwner->GetBaseRotationOffset().Inverse()).Rotator().Yaw;
 
 		if (FMath::IsNearlyZero(FMath::UnwindDegrees(TargetDeltaRemaining), AngleTolerance))
@@ -444,23 +516,8 @@ void UExtCharacterAnimInstance::NativeUpdateTurnInPlace(float DeltaSeconds)
 					bIsTurnInPlaceLong = false;
 				}
 
-				if (bIsCrouched)
-				{
+				if (Stance != FExtCharacterTurnInPlaceTable::Normal)
 					bIsTurnInPlaceLong = false;
-					TurnInPlaceRightAnimPositionCrouched = TurnInPlaceRightCurveCrouched ? TurnInPlaceRightCurveCrouched->GetFloatValue(FMath::Fmod(TargetDeltaRemaining, 90.0f)) : 0.f;
-				}
-				else if (bIsPerformingGenericAction)
-				{
-					bIsTurnInPlaceLong = false;
-					TurnInPlaceRightAnimPositionLeftFootFwd = TurnInPlaceRightCurveLeftFootFwd ? TurnInPlaceRightCurveLeftFootFwd->GetFloatValue(FMath::Fmod(TargetDeltaRemaining, 90.0f)) : 0.f;
-				}
-				else
-				{
-					if (bIsTurnInPlaceLong)
-						TurnInPlaceRightLongAnimPositionNormal = TurnInPlaceRightLongCurveNormal ? TurnInPlaceRightLongCurveNormal->GetFloatValue(FMath::Fmod(TargetDeltaRemaining, 180.0f)) : 0.f;
-					else
-						TurnInPlaceRightShortAnimPositionNormal = TurnInPlaceRightShortCurveNormal ? TurnInPlaceRightShortCurveNormal->GetFloatValue(FMath::Fmod(TargetDeltaRemaining, 90.0f)) : 0.f;
-				}
 			}
 			else
 			{
@@ -484,24 +541,22 @@ void UExtCharacterAnimInstance::NativeUpdateTurnInPlace(float DeltaSeconds)
 					bIsTurnInPlaceLong = false;
 				}
 
-				if (bIsCrouched)
-				{
-					bIsTurnInPlaceLong = false;
-					TurnInPlaceLeftAnimPositionCrouched = TurnInPlaceLeftCurveCrouched ? TurnInPlaceLeftCurveCrouched->GetFloatValue(FMath::Fmod(TargetDeltaRemaining, 90.0f)) : 0.f;
-				}
-				else if (bIsPerformingGenericAction)
-				{
+				if (Stance != FExtCharacterTurnInPlaceTable::Normal)
 					bIsTurnInPlaceLong = false;
-					TurnInPlaceLeftAnimPositionLeftFootFwd = TurnInPlaceLeftCurveLeftFootFwd ? TurnInPlaceLeftCurveLeftFootFwd->GetFloatValue(FMath::Fmod(TargetDeltaRemaining, 90.0f)) : 0.f;
-				}
-				else
-				{
-					if (bIsTurnInPlaceLong)
-						TurnInPlaceLeftLongAnimPositionNormal = TurnInPlaceLeftLongCurveNormal ? TurnInPlaceLeftLongCurveNormal->GetFloatValue(FMath::Fmod(TargetDeltaRemaining, 180.0f)) : 0.f;
-					else
-						TurnInPlaceLeftShortAnimPositionNormal = TurnInPlaceLeftShortCurveNormal ? TurnInPlaceLeftShortCurveNormal->GetFloatValue(FMath::Fmod(TargetDeltaRemaining, 90.0f)) : 0.f;
-				}
 			}
+
+			// Anim position members indexed the same way as the table samples: [Stance][bRight][bLong]
+			static float UExtCharacterAnimInstance::* const AnimPositions[FExtCharacterTurnInPlaceTable::NumStances][2][2] =
+			{
+				{ { &ThisClass::TurnInPlaceLeftShortAnimPositionNormal, &ThisClass::TurnInPlaceLeftLongAnimPositionNormal },
+				  { &ThisClass::TurnInPlaceRightShortAnimPositionNormal, &ThisClass::TurnInPlaceRightLongAnimPositionNormal } },
+				{ { &ThisClass::TurnInPlaceLeftAnimPositionLeftFootFwd, nullptr },
+				  { &ThisClass::TurnInPlaceRightAnimPositionLeftFootFwd, nullptr } },
+				{ { &ThisClass::TurnInPlaceLeftAnimPositionCrouched, nullptr },
+				  { &ThisClass::TurnInPlaceRightAnimPositionCrouched, nullptr } },
+			};
+
+			this->*AnimPositions[Stance][bIsTurningInPlaceRight][bIsTurnInPlaceLong] = GetTurnInPlaceTable().Evaluate(Stance, bIsTurningInPlaceRight, bIsTurnInPlaceLong, TargetDeltaRemaining);
 		}
 	}
 }
@@ -514,10 +569,11 @@ void UExtCharacterAnimInstance::NativeUpdateAimOffset(float DeltaSeconds)
 
 	if (MovementMode != MOVE_None && (MovementMode != MOVE_Falling || bIsJumping))
 	{
-		if (IsValid(LookAtActor))
+		FVector LookAtLocation;
+		if (CharacterOwner->GetLookAtLocation(LookAtLocation))
 		{
 			// Look at target
-			const FVector DeltaLoc = LookAtActor->GetTargetLocation(CharacterOwner) - CharacterOwner->GetPawnViewLocation();
+			const FVector DeltaLoc = LookAtLocation - CharacterOwner->GetPawnViewLocation();
 			const FRotator Delta = (FRotationMatrix::MakeFromX(DeltaLoc).Rotator() - CharacterOwner->GetActorRotation()).GetNormalized();
 			TargetAimOffset = FVector2D(Delta.Yaw, bIsJumping && Velocity.Z < 0.f ? Delta.Pitch - 60.f : Delta.Pitch);
 			AimDistance = DeltaLoc.Size();
@@ -553,6 +609,7 @@ void UExtCharacterAnimInstance::NativeUpdateAimOffset(float DeltaSeconds)
 		}
 	}
 
+	AimOffsetCurrentInterpSpeed = InterpSpeed;
 	AimOffset = FMathEx::Vector2DSafeInterpTo(AimOffset, TargetAimOffset, DeltaSeconds, InterpSpeed);
 	if (AimOffsetMaxAngle > 0.0f)
 	{
@@ -563,18 +620,127 @@ void UExtCharacterAnimInstance::NativeUpdateAimOffset(float DeltaSeconds)
 	AimLocation = CharacterOwner->GetActorRotation().RotateVector(AimLocation) + CharacterOwner->GetPawnViewLocation();
 }
 
+void UExtCharacterAnimInstance::GatherInputs(FExtCharacterAnimInputs& OutInputs) const
+{
+	OutInputs.MeshLocation = CharacterOwnerMesh->GetComponentLocation();
+	OutInputs.Velocity = CharacterOwnerMovement->Velocity;
+	OutInputs.Acceleration = CharacterOwnerMovement->GetCurrentAcceleration();
+	OutInputs.CharacterRotation = CharacterOwner->GetActorRotation();
+	OutInputs.LookRotation = CharacterOwner->GetLookRotation();
+	OutInputs.LookAtActor = CharacterOwner->GetLookAtActor();
+	if (!CharacterOwner->GetLookAtLocation(OutInputs.LookAtLocation))
+		OutInputs.LookAtLocation = FVector::ZeroVector;
+	OutInputs.TurnInPlaceTargetYaw = CharacterOwnerMovement->GetTurnInPlaceTargetYaw();
+	OutInputs.MovementMode = CharacterOwnerMovement->MovementMode;
+	OutInputs.CustomMovementMode = CharacterOwnerMovement->CustomMovementMode;
+	OutInputs.Gait = CharacterOwner->GetGait();
+	OutInputs.RotationMode = CharacterOwner->GetRotationMode();
+	OutInputs.TurnInPlaceState = CharacterOwnerMovement->GetTurnInPlaceState();
+	OutInputs.bIsCrouched = CharacterOwner->bIsCrouched;
+	OutInputs.bIsJumping = CharacterOwner->bIsJumping;
+	OutInputs.bIsPerformingGenericAction = CharacterOwner->bIsPerformingGenericAction;
+	OutInputs.bIsPivotTurning = CharacterOwnerMovement->IsPivotTurning();
+	OutInputs.bIsRagdoll = CharacterOwner->IsRagdoll();
+	OutInputs.bIsGettingUp = CharacterOwner->IsGettingUp();
+}
+
+bool UExtCharacterAnimInstance::CanSkipDerivedUpdate(const FExtCharacterAnimInputs& Inputs) const
+{
+	// Values from the previous frame (bWasMoving, LastCharacterRotation, etc) only settle after two full updates with the same inputs.
+	return UnchangedInputsCount > 1
+		&& !bIsMoving
+		&& !bIsAccelerating
+		&& !bIsTurningInPlace
+		&& !bIsPivotTurning
+		&& !bIsRagdoll
+		&& !bIsGettingUp
+		&& RootBoneOffset.X == 0.0f
+		&& !bHasMovementModeChanged
+		&& !bHasGaitChanged
+		&& !bHasCrouchedChanged
+		&& !bHasPerformingGenericActionChanged
+		&& !bHasPendingMontageInterrupt;
+}
+
+void UExtCharacterAnimInstance::NativeUpdateCharacterSettings()
+{
+	GetUpDelay = CharacterOwner->GetUpDelay;
+
+	UseHeadlook = CharacterOwner->UseHeadlook;
+	UseBodylook = CharacterOwner->UseBodylook;
+	bUseLookInputInMovement = CharacterOwner->bUseLookInputInMovement;
+
+	// Enable Foot IK only if enabled by the character, not ragdoll and moving on ground.
+	bEnableFootIK = CharacterOwner->bEnableFootIK && !bIsRagdoll && (MovementMode == MOVE_Walking || MovementMode == MOVE_NavWalking);
+	bEnableLookIK = CharacterOwner->bEnableLookIK && !bIsRagdoll && (MovementMode == MOVE_Walking || MovementMode == MOVE_NavWalking);
+}
+
+void UExtCharacterAnimInstance::NativeUpdateInterpolators(float DeltaSeconds)
+{
+	// Every other derived value is stable so only the aim offset may still be converging to its target.
+	// AimLocation depends on the actor transform which is part of the inputs so it only has to be updated with the offset.
+	if (AimOffset != TargetAimOffset)
+	{
+		AimOffset = FMathEx::Vector2DSafeInterpTo(AimOffset, TargetAimOffset, DeltaSeconds, AimOffsetCurrentInterpSpeed);
+		if (AimOffsetMaxAngle > 0.0f)
+		{
+			AimOffset = AimOffset.ClampAxes(-AimOffsetMaxAngle, AimOffsetMaxAngle);
+		}
+
+		AimLocation = UKismetMathLibrary::CreateVectorFromYawPitch(AimOffset.X, AimOffset.Y, AimDistance);
+		AimLocation = CharacterOwner->GetActorRotation().RotateVector(AimLocation) + CharacterOwner->GetPawnViewLocation();
+	}
+}
+
+const FExtCharacterTurnInPlaceTable& UExtCharacterAnimInstance::GetTurnInPlaceTable() const
+{
+	// Turn in place curves are only editable in the defaults so the table is owned by the CDO and shared by every instance.
+	const UExtCharacterAnimInstance* AnimDefaults = HasAnyFlags(RF_ClassDefaultObject) ? this : GetClass()->GetDefaultObject<UExtCharacterAnimInstance>();
+	if (!AnimDefaults->TurnInPlaceTable.IsValid())
+	{
+		AnimDefaults->TurnInPlaceTable = MakeShared<FExtCharacterTurnInPlaceTable>();
+		AnimDefaults->TurnInPlaceTable->Build(AnimDefaults);
+	}
+
+	return *AnimDefaults->TurnInPlaceTable;
+}
+
+void UExtCharacterAnimInstance::InvalidateTurnInPlaceTable()
+{
+	UExtCharacterAnimInstance* AnimDefaults = HasAnyFlags(RF_ClassDefaultObject) ? this : GetClass()->GetDefaultObject<UExtCharacterAnimInstance>();
+	AnimDefaults->TurnInPlaceTable.Reset();
+}
+
 void UExtCharacterAnimInstance::RaiseEvents()
 {
 	if (bHasMovementModeChanged)
 	{
 		bHasMovementModeChanged = false;
 
-		if (!bIsRagdoll)
-			StopAllMontages(0.1f);
+		if (bHasPendingMontageInterrupt && MovementMode == MontageInterruptFromMode && CustomMovementMode == MontageInterruptFromCustomMode)
+		{
+			// Changed back before the interrupt took effect, e.g. walking off a small ledge
+			bHasPendingMontageInterrupt = false;
+			INC_DWORD_STAT(STAT_MontageInterruptsFiltered);
+		}
+		else if (!bIsRagdoll)
+		{
+			bHasPendingMontageInterrupt = true;
+			MontageInterruptTime = GetWorld()->GetTimeSeconds();
+
+			MontageInterruptInstanceIDs.Reset();
+			for (const FAnimMontageInstance* MontageInstance : MontageInstances)
+			{
+				if (MontageInstance && MontageInstance->IsActive())
+					MontageInterruptInstanceIDs.Add(MontageInstance->GetInstanceID());
+			}
+		}
 
 		OnMovementModeChanged();
 	}
 
+	UpdateMontageInterrupts();
+
 	if (bHasGaitChanged)
 	{
 		bHasGaitChanged = false;
@@ -594,6 +760,52 @@ void UExtCharacterAnimInstance::RaiseEvents()
 	}
 }
 
+void UExtCharacterAnimInstance::UpdateMontageInterrupts()
+{
+	if (!bHasPendingMontageInterrupt)
+		return;
+
+	if (bIsRagdoll)
+	{
+		bHasPendingMontageInterrupt = false;
+		return;
+	}
+
+	const float ElapsedTime = GetWorld()->GetTimeSeconds() - MontageInterruptTime;
+	bool bIsWaiting = false;
+
+	// Stopping does not remove the instance right away but iterate backwards like StopAllMontages anyway
+	for (int32 Index = MontageInstances.Num() - 1; Index >= 0; --Index)
+	{
+		FAnimMontageInstance* MontageInstance = MontageInstances[Index];
+		if (!MontageInstance || !MontageInstance->IsActive() || !MontageInterruptInstanceIDs.Contains(MontageInstance->GetInstanceID()))
+			continue;
+
+		const UMontageInterruptPolicyAssetUserData* Policy = UMontageInterruptPolicyAssetUserData::Find(MontageInstance->Montage);
+		const int32 InterruptingModes = Policy ? Policy->InterruptingMovementModes : DefaultMontageInterruptingMovementModes;
+		if ((InterruptingModes & (1 << MovementMode)) == 0)
+			continue;
+
+		if (MovementMode == MOVE_Falling)
+		{
+			const float Delay = Policy && Policy->FallingInterruptDelay >= 0.f ? Policy->FallingInterruptDelay : FallingMontageInterruptDelay;
+			if (ElapsedTime < Delay)
+			{
+				bIsWaiting = true;
+				continue;
+			}
+		}
+
+		MontageInstance->Stop(FAlphaBlend(MontageInterruptBlendOutTime));
+		++NumMontagesStoppedByMovementMode;
+		INC_DWORD_STAT(STAT_MontagesStoppedByMovementMode);
+	}
+
+	bHasPendingMontageInterrupt = bIsWaiting;
+	if (!bHasPendingMontageInterrupt)
+		MontageInterruptInstanceIDs.Reset();
+}
+
 
 /// Setters
 
@@ -601,6 +813,12 @@ void UExtCharacterAnimInstance::SetMovementMode(const EMovementMode Value, const
 {
 	if (MovementMode != Value || (Value == MOVE_Custom && CustomMovementMode != CustomValue))
 	{
+		if (!bHasPendingMontageInterrupt && !bHasMovementModeChanged)
+		{
+			MontageInterruptFromMode = MovementMode;
+			MontageInterruptFromCustomMode = CustomMovementMode;
+		}
+
 		MovementMode = Value;
 		CustomMovementMode = CustomValue;
 		bHasMovementModeChanged = true;
@@ -721,3 +939,10 @@ float UExtCharacterAnimInstance::FindCurveTimeFromValue(UAnimSequence* InAnimSeq
 	return 0.0f;
 }
 
+float UExtCharacterAnimInstance::FindTimeFromDistance(UAnimSequence* InAnimSequence, const float Distance, const bool bRemaining) const
+{
+	if (const UDistanceMatchingAssetUserData* DistanceMatchingData = UDistanceMatchingAssetUserData::Find(InAnimSequence))
+		return bRemaining ? DistanceMatchingData->GetTimeFromDistanceRemaining(Distance) : DistanceMatchingData->GetTimeFromDistance(Distance);
+
+	return 0.0f;
+}
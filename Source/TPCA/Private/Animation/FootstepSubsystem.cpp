@@ -0,0 +1,181 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "Animation/FootstepSubsystem.h"
+#include "Components/AudioComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "Sound/SoundBase.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Footsteps Played"), STAT_FootstepsPlayed, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Footsteps Culled"), STAT_FootstepsCulled, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Footsteps Per Second"), STAT_FootstepsPerSecond, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Footsteps Culled Per Second"), STAT_FootstepsCulledPerSecond, STATGROUP_Character);
+
+UFootstepSubsystem::UFootstepSubsystem()
+{
+	ListenerLocationsFrame = 0;
+	NumPlaying = 0;
+	NumPlayingFrame = 0;
+	StatsWindowStartTime = 0.0;
+	FootstepsInWindow = 0;
+	CulledInWindow = 0;
+	LastFootstepsPerSecond = 0;
+	LastCulledPerSecond = 0;
+}
+
+void UFootstepSubsystem::Deinitialize()
+{
+	for (UAudioComponent* AudioComponent : AudioComponents)
+	{
+		if (AudioComponent)
+			AudioComponent->DestroyComponent();
+	}
+	AudioComponents.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UFootstepSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer))
+		return false;
+
+	const EWorldType::Type WorldType = CastChecked<UWorld>(Outer)->WorldType;
+
+	// Editor preview worlds are left out so that footsteps in the animation editor keep using plain one shot sounds
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UFootstepSubsystem::ShouldPlayFootstep(const FVector& Location, float MaxDistance, int32 MaxConcurrent)
+{
+	UpdateStatsWindow();
+
+	const UWorld* World = GetWorld();
+	bool bAudible = World->GetNetMode() != NM_DedicatedServer && World->bAllowAudioPlayback;
+
+	if (bAudible && MaxDistance > 0.f)
+	{
+		UpdateListenerLocations();
+
+		const float MaxDistanceSquared = FMath::Square(MaxDistance);
+		bAudible = false;
+		for (const FVector& ListenerLocation : ListenerLocations)
+		{
+			if (FVector::DistSquared(ListenerLocation, Location) <= MaxDistanceSquared)
+			{
+				bAudible = true;
+				break;
+			}
+		}
+	}
+
+	if (bAudible && MaxConcurrent > 0)
+	{
+		UpdateNumPlaying();
+		bAudible = NumPlaying < MaxConcurrent;
+	}
+
+	if (!bAudible)
+	{
+		INC_DWORD_STAT(STAT_FootstepsCulled);
+		++CulledInWindow;
+	}
+
+	return bAudible;
+}
+
+void UFootstepSubsystem::PlayFootstep(USoundBase* Sound, const FVector& Location, float VolumeMultiplier, float PitchMultiplier)
+{
+	UAudioComponent* AudioComponent = Sound ? AcquireAudioComponent() : nullptr;
+	if (!AudioComponent)
+		return;
+
+	AudioComponent->SetWorldLocation(Location);
+	AudioComponent->SetSound(Sound);
+	AudioComponent->SetVolumeMultiplier(VolumeMultiplier);
+	AudioComponent->SetPitchMultiplier(PitchMultiplier);
+	AudioComponent->Play();
+
+	++NumPlaying;
+	INC_DWORD_STAT(STAT_FootstepsPlayed);
+	++FootstepsInWindow;
+}
+
+void UFootstepSubsystem::UpdateListenerLocations()
+{
+	if (ListenerLocationsFrame == GFrameCounter)
+		return;
+
+	ListenerLocationsFrame = GFrameCounter;
+	ListenerLocations.Reset();
+
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PC = Iterator->Get();
+		if (PC && PC->IsLocalPlayerController())
+		{
+			FVector Location, FrontDir, RightDir;
+			PC->GetAudioListenerPosition(Location, FrontDir, RightDir);
+			ListenerLocations.Add(Location);
+		}
+	}
+}
+
+void UFootstepSubsystem::UpdateNumPlaying()
+{
+	if (NumPlayingFrame == GFrameCounter)
+		return;
+
+	NumPlayingFrame = GFrameCounter;
+	NumPlaying = 0;
+
+	for (const UAudioComponent* AudioComponent : AudioComponents)
+	{
+		if (AudioComponent && AudioComponent->IsPlaying())
+			++NumPlaying;
+	}
+}
+
+void UFootstepSubsystem::UpdateStatsWindow()
+{
+	const double Now = FPlatformTime::Seconds();
+	if (Now - StatsWindowStartTime < 1.0)
+		return;
+
+	// Scale in case the window was longer than a second because nothing played
+	const double WindowLength = StatsWindowStartTime > 0.0 ? Now - StatsWindowStartTime : 1.0;
+	LastFootstepsPerSecond = FMath::RoundToInt(FootstepsInWindow / WindowLength);
+	LastCulledPerSecond = FMath::RoundToInt(CulledInWindow / WindowLength);
+	SET_DWORD_STAT(STAT_FootstepsPerSecond, LastFootstepsPerSecond);
+	SET_DWORD_STAT(STAT_FootstepsCulledPerSecond, LastCulledPerSecond);
+
+	StatsWindowStartTime = Now;
+	FootstepsInWindow = 0;
+	CulledInWindow = 0;
+}
+
+UAudioComponent* UFootstepSubsystem::AcquireAudioComponent()
+{
+	for (UAudioComponent* AudioComponent : AudioComponents)
+	{
+		if (AudioComponent && !AudioComponent->IsPlaying())
+			return AudioComponent;
+	}
+
+	UWorld* World = GetWorld();
+	AWorldSettings* WorldSettings = World->GetWorldSettings();
+	if (!WorldSettings)
+		return nullptr;
+
+	// Same setup as UGameplayStatics::SpawnSoundAtLocation except that the component is kept alive for reuse
+	UAudioComponent* AudioComponent = NewObject<UAudioComponent>(WorldSettings, NAME_None, RF_Transient);
+	AudioComponent->bAutoActivate = false;
+	AudioComponent->bAutoDestroy = false;
+	AudioComponent->bAllowSpatialization = true;
+	AudioComponent->bIsUISound = false;
+	AudioComponent->RegisterComponentWithWorld(World);
+
+	AudioComponents.Add(AudioComponent);
+	return AudioComponent;
+}
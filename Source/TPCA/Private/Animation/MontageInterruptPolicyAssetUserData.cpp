@@ -0,0 +1,16 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "Animation/MontageInterruptPolicyAssetUserData.h"
+#include "Animation/AnimMontage.h"
+
+UMontageInterruptPolicyAssetUserData::UMontageInterruptPolicyAssetUserData()
+{
+	InterruptingMovementModes = ~0;
+	FallingInterruptDelay = -1.f;
+}
+
+UMontageInterruptPolicyAssetUserData* UMontageInterruptPolicyAssetUserData::Find(const UAnimMontage* Montage)
+{
+	// GetAssetUserDataOfClass is not const
+	return Montage ? Cast<UMontageInterruptPolicyAssetUserData>(const_cast<UAnimMontage*>(Montage)->GetAssetUserDataOfClass(StaticClass())) : nullptr;
+}
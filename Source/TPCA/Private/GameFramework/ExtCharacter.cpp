@@ -4,6 +4,7 @@
 #include "GameFramework/ExtCharacterMovementComponent.h"
 
 #include "GameFramework/PlayerController.h"
+#include "GameFramework/GameNetworkManager.h"
 #include "Components/SceneComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/ExtInputComponent.h"
@@ -29,6 +30,44 @@
 
 DEFINE_LOG_CATEGORY_STATIC(LogExtCharacter, Log, All);
 
+DECLARE_CYCLE_STAT(TEXT("Char Broadcast CrouchChanged"), STAT_ExtCharacterBroadcastCrouchChanged, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char Broadcast GenericActionChanged"), STAT_ExtCharacterBroadcastGenericActionChanged, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char Broadcast GaitChanged"), STAT_ExtCharacterBroadcastGaitChanged, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char Broadcast RotationModeChanged"), STAT_ExtCharacterBroadcastRotationModeChanged, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char Broadcast RagdollChanged"), STAT_ExtCharacterBroadcastRagdollChanged, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char Broadcast HitReact"), STAT_ExtCharacterBroadcastHitReact, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Look Replication Updates"), STAT_ExtCharacterLookReplicationUpdates, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Look Replication Skipped"), STAT_ExtCharacterLookReplicationSkipped, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char Gather ExtMovement"), STAT_ExtCharacterGatherExtMovement, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char ExtMovement Gathered Changed"), STAT_ExtCharacterExtMovementChanged, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char ExtMovement Gathered Unchanged"), STAT_ExtCharacterExtMovementUnchanged, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char ExtMovement Acceleration Derived"), STAT_ExtCharacterExtMovementAccelerationDerived, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char OnRep ExtMovement"), STAT_ExtCharacterOnRepExtMovement, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char ExtMovement Updates Received"), STAT_ExtCharacterExtMovementReceived, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char ExtMovement Transform Updates Skipped"), STAT_ExtCharacterExtMovementSkipped, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Input Intents"), STAT_ExtCharacterInputIntents, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Input Intent Transitions"), STAT_ExtCharacterInputIntentTransitions, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Input Intent Transitions Per Second"), STAT_ExtCharacterInputIntentTransitionsPerSecond, STATGROUP_Character);
+
+DECLARE_CYCLE_STAT(TEXT("Char IsNetRelevantFor"), STAT_ExtCharacterIsNetRelevantFor, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Net Relevancy Culled"), STAT_ExtCharacterNetRelevancyCulled, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Net Relevancy Visibility Traces"), STAT_ExtCharacterNetRelevancyTraces, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char OnRep ExtState"), STAT_ExtCharacterOnRepExtState, STATGROUP_Character);
+
+/** Layout of AExtCharacter::ReplicatedExtState. The low byte is ReplicatedExtMovementMode, movement mode plus the jump bit. */
+namespace ExtState
+{
+	static const uint16 MovementModeMask = 0x00FF;
+	static const int32 RotationModeShift = 8;
+	static const uint16 RotationModeMask = 0x0300;
+	static const uint16 Walking = 1 << 10;
+	static const uint16 Sprinting = 1 << 11;
+	static const uint16 PerformingGenericAction = 1 << 12;
+}
+
+static double GInputIntentWindowStartTime = 0.0;
+static int32 GInputIntentTransitionsInWindow = 0;
+
 #define LOCTEXT_NAMESPACE "ExtCharacter"
 
 AExtCharacter::AExtCharacter(const FObjectInitializer& ObjectInitializer)
@@ -136,6 +175,38 @@ AExtCharacter::AExtCharacter(const FObjectInitializer& ObjectInitializer)
 	LookUpInputSpeed = 0.0f;
 	LookRightInputSpeed = 0.0f;
 
+	LookReplicationDeadBand = 0.5f;
+	LookReplicationMaxRate = 20.0f;
+	LookSmoothingSpeed = 15.0f;
+	LookPredictionMaxTime = 0.1f;
+	bRelevancyAwareLookAt = true;
+	LookAtLocationUpdateRate = 4.0f;
+	LookAtLocationTolerance = 10.0f;
+	bCompactReplicatedState = true;
+	ExtMovementLocationThreshold = 0.0f;
+	ExtMovementRotationThreshold = 0.0f;
+	ExtMovementVelocityThreshold = 0.0f;
+	ExtMovementAccelerationThreshold = 0.0f;
+	bDirectProxyReceive = true;
+	ProxyReceiveLocationTolerance = 1.0f;
+	ProxyReceiveRotationTolerance = 0.5f;
+	bUseExtNetRelevancy = false;
+	WalkRelevancyScale = 0.85f;
+	SprintRelevancyScale = 1.5f;
+	CrouchRelevancyScale = 0.75f;
+	RagdollRelevancyScale = 0.5f;
+	LookAtRelevancyScale = 1.25f;
+	LookAtRelevancyAngle = 15.0f;
+	OccludedRelevancyScale = 0.6f;
+	RelevancyVisibilityInterval = 0.5f;
+	NextRelevancyVisibilityPruneTime = 0.0f;
+	LastLookAtLocationUpdateTime = -BIG_NUMBER;
+	CurrentLookRotation = FRotator::ZeroRotator;
+	LastLookReplicationTime = -BIG_NUMBER;
+	ProxyLookAngularVelocity = FRotator::ZeroRotator;
+	LastReceivedLookRotation = FRotator::ZeroRotator;
+	ProxyLookReceiveTime = -1.0f;
+
 	// Camera control settings
 	bFindCameraComponentWhenViewTarget = true;
 	bRelayCameraFunctionsToController = false;
@@ -179,6 +250,8 @@ AExtCharacter::AExtCharacter(const FObjectInitializer& ObjectInitializer)
 
 	bIgnoreLookInputWhenRagdoll = false;
 	bIgnoreMoveInputWhenRagdoll = true;
+	bBufferInputIntents = true;
+	bGenericActionPressLatched = false;
 
 	MovementSettings.Primary.Standing.Walk.MaxSpeed = 165.f;
 	MovementSettings.Primary.Standing.Walk.MaxAcceleration = 800.f;
@@ -392,9 +465,11 @@ void AExtCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty> & OutLi
 	DOREPLIFETIME_CONDITION(AExtCharacter, ReplicatedExtMovement, COND_SimulatedOrPhysicsNoReplay);
 
 	DOREPLIFETIME_CONDITION(AExtCharacter, ReplicatedExtMovementMode, COND_SimulatedOnly);
+	DOREPLIFETIME_CONDITION(AExtCharacter, ReplicatedExtState, COND_SimulatedOnly);
 
 	DOREPLIFETIME_CONDITION(AExtCharacter, ReplicatedLook, COND_SimulatedOnly);
 	DOREPLIFETIME_CONDITION(AExtCharacter, ReplicatedLookAtActor, COND_SimulatedOnly);
+	DOREPLIFETIME_CONDITION(AExtCharacter, ReplicatedLookAt, COND_SimulatedOnly);
 	DOREPLIFETIME_CONDITION(AExtCharacter, RotationMode, COND_SimulatedOnly);
 
 	DOREPLIFETIME_CONDITION(AExtCharacter, bIsWalkingInsteadOfRunning, COND_SimulatedOnly);
@@ -440,6 +515,13 @@ void AExtCharacter::PreReplication(IRepChangedPropertyTracker & ChangedPropertyT
 		ChangedPropertyTracker.SetCustomIsActiveOverride(this, ReplicatedMovementModeProperty->RepIndex, false);
 	}
 
+	// Only one of the look at properties is replicated
+	if (bRelevancyAwareLookAt)
+		UpdateReplicatedLookAt();
+
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AExtCharacter, ReplicatedLookAtActor, !bRelevancyAwareLookAt);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AExtCharacter, ReplicatedLookAt, bRelevancyAwareLookAt);
+
 	// Workaround: RemoteViewPitch is taken from ReplicatedLook.Rotation.Pitch
 	DOREPLIFETIME_ACTIVE_OVERRIDE(ACharacter, RemoteViewPitch, false);
 
@@ -494,6 +576,17 @@ void AExtCharacter::PreReplication(IRepChangedPropertyTracker & ChangedPropertyT
 	if (bIsJumping)
 		ReplicatedExtMovementMode |= uint8(0x80);
 
+	// Either the packed state or the separate properties are replicated, never both
+	if (bCompactReplicatedState)
+		ReplicatedExtState = PackReplicatedExtState(ReplicatedExtMovementMode);
+
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AExtCharacter, ReplicatedExtState, bCompactReplicatedState);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AExtCharacter, ReplicatedExtMovementMode, !bCompactReplicatedState);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AExtCharacter, RotationMode, !bCompactReplicatedState);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AExtCharacter, bIsWalkingInsteadOfRunning, !bCompactReplicatedState);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AExtCharacter, bIsSprinting, !bCompactReplicatedState);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(AExtCharacter, bIsPerformingGenericAction, !bCompactReplicatedState);
+
 	ReplicatedBasedMovement = BasedMovement;
 
 	// Optimization: only update and replicate these values if they are actually going to be used.
@@ -510,7 +603,10 @@ void AExtCharacter::PreReplication(IRepChangedPropertyTracker & ChangedPropertyT
 	}
 
 	// Save bandwidth by not replicating this value unless it is necessary, since it changes every update.
-	if ((MyCharacterMovement->NetworkSmoothingMode != ENetworkSmoothingMode::Linear) && !MyCharacterMovement->bNetworkAlwaysReplicateTransformUpdateTimestamp)
+	// Proxies may still pick linear smoothing through the smoothing LOD when the authored mode is exponential.
+	const UExtCharacterMovementComponent* ExtCharacterMovement = CastChecked<UExtCharacterMovementComponent>(MyCharacterMovement);
+	const bool bSmoothingLODCanUseLinear = ExtCharacterMovement->bEnableSmoothingLOD && ExtCharacterMovement->NetworkSmoothingMode == ENetworkSmoothingMode::Exponential;
+	if ((MyCharacterMovement->NetworkSmoothingMode != ENetworkSmoothingMode::Linear) && !bSmoothingLODCanUseLinear && !MyCharacterMovement->bNetworkAlwaysReplicateTransformUpdateTimestamp)
 	{
 		ReplicatedServerLastTransformUpdateTimeStamp = 0.f;
 	}
@@ -530,12 +626,48 @@ bool AExtCharacter::GatherExtMovement()
 			UExtCharacterMovementComponent* ExtCharacterMovement = GetExtCharacterMovement();
 			check(ExtCharacterMovement);
 
-			ReplicatedExtMovement.Location = RootComponent->GetComponentLocation();
-			ReplicatedExtMovement.Rotation = RootComponent->GetComponentRotation();
-			ReplicatedExtMovement.Velocity = ExtCharacterMovement->Velocity;
-			ReplicatedExtMovement.Acceleration = ExtCharacterMovement->GetCurrentAcceleration().GetSafeNormal();
-			ReplicatedExtMovement.bIsPivotTurning = ExtCharacterMovement->IsPivotTurning();
-			ReplicatedExtMovement.TurnInPlaceTargetYaw = ExtCharacterMovement->GetTurnInPlaceTargetYaw();
+			SCOPE_CYCLE_COUNTER(STAT_ExtCharacterGatherExtMovement);
+
+			FRepExtMovement NewExtMovement = ReplicatedExtMovement;
+			NewExtMovement.Location = RootComponent->GetComponentLocation();
+			NewExtMovement.Rotation = RootComponent->GetComponentRotation();
+			NewExtMovement.Velocity = ExtCharacterMovement->Velocity;
+			NewExtMovement.Acceleration = ExtCharacterMovement->GetCurrentAcceleration().GetSafeNormal();
+			NewExtMovement.bIsPivotTurning = ExtCharacterMovement->IsPivotTurning();
+
+			// Predicted turns keep the last sent target so that they do not count as a change
+			NewExtMovement.bTurnInPlacePredicted = ExtCharacterMovement->CanProxyPredictTurnInPlace();
+			if (!NewExtMovement.bTurnInPlacePredicted)
+				NewExtMovement.TurnInPlaceTargetYaw = ExtCharacterMovement->GetTurnInPlaceTargetYaw();
+
+			// Compare in the quantized domain so that changes which would produce the same bits on the wire leave the property untouched
+			NewExtMovement.Quantize();
+
+			// Proxies derive acceleration from the velocity in the same update only, so skipped or dropped updates cannot make them disagree
+			// with the server. Acceleration keeps what proxies end up with either way so that an unchanged derived value is not a change.
+			NewExtMovement.bAccelerationDerived = false;
+			NewExtMovement.bAccelerationAlongVelocity = false;
+			if (ExtCharacterMovement->bDeriveProxyAcceleration)
+			{
+				const FVector AccelerationAlongVelocity = ExtCharacterMovement->DeriveAcceleration(NewExtMovement.Velocity, true);
+				const bool bAlongVelocity = FVector::Dist(AccelerationAlongVelocity, NewExtMovement.Acceleration) <= ExtCharacterMovement->DerivedAccelerationMaxError;
+				if (bAlongVelocity || NewExtMovement.Acceleration.Size() <= ExtCharacterMovement->DerivedAccelerationMaxError)
+				{
+					NewExtMovement.bAccelerationDerived = true;
+					NewExtMovement.bAccelerationAlongVelocity = bAlongVelocity;
+					NewExtMovement.Acceleration = bAlongVelocity ? AccelerationAlongVelocity : FVector::ZeroVector;
+					INC_DWORD_STAT(STAT_ExtCharacterExtMovementAccelerationDerived);
+				}
+			}
+			if (NewExtMovement.IsNearlyEqual(ReplicatedExtMovement, ExtMovementLocationThreshold, ExtMovementRotationThreshold, ExtMovementVelocityThreshold, ExtMovementAccelerationThreshold))
+			{
+				INC_DWORD_STAT(STAT_ExtCharacterExtMovementUnchanged);
+			}
+			else
+			{
+				ReplicatedExtMovement = NewExtMovement;
+				INC_DWORD_STAT(STAT_ExtCharacterExtMovementChanged);
+			}
 
 			return true;
 		}
@@ -544,6 +676,120 @@ bool AExtCharacter::GatherExtMovement()
 	return false;
 }
 
+bool AExtCharacter::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	if (!bUseExtNetRelevancy || !GetDefault<AGameNetworkManager>()->bUseDistanceBasedRelevancy)
+		return Super::IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
+
+	// Full override to replace the distance test at the end of APawn::IsNetRelevantFor, everything before it is kept as is
+	FULL_OVERRIDE();
+
+	SCOPE_CYCLE_COUNTER(STAT_ExtCharacterIsNetRelevantFor);
+
+	if (bAlwaysRelevant || RealViewer == Controller || IsOwnedBy(ViewTarget) || IsOwnedBy(RealViewer) || this == ViewTarget || ViewTarget == GetInstigator()
+		|| IsBasedOnActor(ViewTarget) || (ViewTarget && ViewTarget->IsBasedOnActor(this)))
+	{
+		return true;
+	}
+	else if ((IsHidden() || bOnlyRelevantToOwner) && (!GetRootComponent() || !GetRootComponent()->IsCollisionEnabled()))
+	{
+		return false;
+	}
+	else
+	{
+		UPrimitiveComponent* MovementBase = GetMovementBase();
+		AActor* BaseActor = MovementBase ? MovementBase->GetOwner() : nullptr;
+		if (MovementBase && BaseActor && GetMovementComponent() && ((Cast<const USkeletalMeshComponent>(MovementBase)) || (BaseActor == GetOwner())))
+			return BaseActor->IsNetRelevantFor(RealViewer, ViewTarget, SrcLocation);
+	}
+
+	const float DistanceSquared = FVector::DistSquared(SrcLocation, GetActorLocation());
+	const float Scale = GetNetRelevancyDistanceScale(RealViewer, ViewTarget, SrcLocation);
+	if (DistanceSquared >= NetCullDistanceSquared * FMath::Square(Scale))
+	{
+		INC_DWORD_STAT(STAT_ExtCharacterNetRelevancyCulled);
+		return false;
+	}
+
+	// Only test line of sight when the result makes a difference. Characters that can be heard must stay relevant behind cover.
+	if (OccludedRelevancyScale >= 1.0f || DistanceSquared < NetCullDistanceSquared * FMath::Square(Scale * OccludedRelevancyScale) || IsAudibleForNetRelevancy())
+		return true;
+
+	if (IsVisibleForNetRelevancy(RealViewer, ViewTarget, SrcLocation))
+		return true;
+
+	INC_DWORD_STAT(STAT_ExtCharacterNetRelevancyCulled);
+	return false;
+}
+
+float AExtCharacter::GetNetRelevancyDistanceScale(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	float Scale;
+	if (bIsRagdoll)
+	{
+		Scale = RagdollRelevancyScale;
+	}
+	else
+	{
+		Scale = (Gait == ECharacterGait::Sprint) ? SprintRelevancyScale
+			: (Gait == ECharacterGait::Walk) ? WalkRelevancyScale
+			: 1.0f;
+
+		if (bIsCrouched)
+			Scale *= CrouchRelevancyScale;
+	}
+
+	// Characters aiming at or looking at the viewer should not pop in
+	const bool bTargetsViewer = ReplicatedLookAtActor && (ReplicatedLookAtActor == ViewTarget || ReplicatedLookAtActor == RealViewer);
+	if (bTargetsViewer || (!bIsRagdoll && (CurrentLookRotation.Vector() | (SrcLocation - GetPawnViewLocation()).GetSafeNormal()) >= FMath::Cos(FMath::DegreesToRadians(LookAtRelevancyAngle))))
+		Scale = FMath::Max(Scale, LookAtRelevancyScale);
+
+	return Scale;
+}
+
+bool AExtCharacter::IsAudibleForNetRelevancy() const
+{
+	return !bIsRagdoll
+		&& !bIsCrouched
+		&& (Gait == ECharacterGait::Run || Gait == ECharacterGait::Sprint)
+		&& GetVelocity().SizeSquared2D() > KINDA_SMALL_NUMBER;
+}
+
+bool AExtCharacter::IsVisibleForNetRelevancy(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	const UWorld* World = GetWorld();
+	const float Now = World->GetTimeSeconds();
+
+	if (Now >= NextRelevancyVisibilityPruneTime)
+	{
+		NextRelevancyVisibilityPruneTime = Now + 10.0f;
+		const float StaleTime = Now - FMath::Max(RelevancyVisibilityInterval * 4.0f, 10.0f);
+		for (auto It = RelevancyVisibilityCache.CreateIterator(); It; ++It)
+			if (!It.Key().IsValid() || It.Value().UpdateTime < StaleTime)
+				It.RemoveCurrent();
+	}
+
+	FRelevancyVisibility& Visibility = RelevancyVisibilityCache.FindOrAdd(RealViewer, FRelevancyVisibility{ -BIG_NUMBER, true });
+	if (Now - Visibility.UpdateTime >= RelevancyVisibilityInterval)
+	{
+		INC_DWORD_STAT(STAT_ExtCharacterNetRelevancyTraces);
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ExtCharacterNetRelevancy), false, this);
+		QueryParams.AddIgnoredActor(ViewTarget);
+
+		// Other characters standing in between don't hide this one
+		FCollisionResponseParams ResponseParams;
+		ResponseParams.CollisionResponse.SetResponse(ECC_Pawn, ECR_Ignore);
+
+		// Either the head or the feet being visible is enough, the feet are only tested when the head is not
+		Visibility.bVisible = !World->LineTraceTestByChannel(SrcLocation, GetPawnViewLocation(), ECC_Visibility, QueryParams, ResponseParams)
+			|| !World->LineTraceTestByChannel(SrcLocation, GetActorLocation(), ECC_Visibility, QueryParams, ResponseParams);
+		Visibility.UpdateTime = Now;
+	}
+
+	return Visibility.bVisible;
+}
+
 void AExtCharacter::PreNetReceive()
 {
 	// Full override because parent class implementation became obsolete with this class having a custom replicated movement mode.
@@ -571,6 +817,16 @@ void AExtCharacter::OnRep_ReplicatedExtMovement()
 {
 	if (GetLocalRole() == ROLE_SimulatedProxy)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_ExtCharacterOnRepExtMovement);
+		INC_DWORD_STAT(STAT_ExtCharacterExtMovementReceived);
+
+		// Attachment is resolved by the generic path
+		if (bDirectProxyReceive && !GetAttachmentReplication().AttachParent)
+		{
+			ApplyReplicatedExtMovement();
+			return;
+		}
+
 		FRepMovement& MutableRepMovement = GetReplicatedMovement_Mutable();
 
 		MutableRepMovement.Location = ReplicatedExtMovement.Location;
@@ -584,10 +840,62 @@ void AExtCharacter::OnRep_ReplicatedExtMovement()
 
 		UExtCharacterMovementComponent* ExtCharacterMovement = GetExtCharacterMovement();
 		check(ExtCharacterMovement);
-		ExtCharacterMovement->SetReplicatedAcceleration(ReplicatedExtMovement.Acceleration);
+		ExtCharacterMovement->SetReplicatedAcceleration(ReplicatedExtMovement.bAccelerationDerived
+			? ExtCharacterMovement->DeriveAcceleration(ReplicatedExtMovement.Velocity, ReplicatedExtMovement.bAccelerationAlongVelocity)
+			: ReplicatedExtMovement.Acceleration);
 		ExtCharacterMovement->SetReplicatedPivotTurn(ReplicatedExtMovement.bIsPivotTurning);
-		ExtCharacterMovement->SetReplicatedTurnInPlace(ReplicatedExtMovement.TurnInPlaceTargetYaw);
+		if (ReplicatedExtMovement.bTurnInPlacePredicted)
+			ExtCharacterMovement->SetPredictedTurnInPlace();
+		else
+			ExtCharacterMovement->SetReplicatedTurnInPlace(ReplicatedExtMovement.TurnInPlaceTargetYaw);
+	}
+}
+
+void AExtCharacter::ApplyReplicatedExtMovement()
+{
+	UExtCharacterMovementComponent* ExtCharacterMovement = GetExtCharacterMovement();
+	check(ExtCharacterMovement);
+
+	// Keep ReplicatedMovement current for code that reads it, it no longer drives the update
+	FRepMovement& MutableRepMovement = GetReplicatedMovement_Mutable();
+	MutableRepMovement.Location = ReplicatedExtMovement.Location;
+	MutableRepMovement.Rotation = ReplicatedExtMovement.Rotation;
+	MutableRepMovement.LinearVelocity = ReplicatedExtMovement.Velocity;
+
+	ExtCharacterMovement->Velocity = ReplicatedExtMovement.Velocity;
+
+	// Don't change transform if using relative position (it should be nearly the same anyway, or base may be slightly out of sync)
+	if (!ReplicatedBasedMovement.HasRelativeLocation())
+	{
+		const FVector OldLocation = GetActorLocation();
+		const FQuat OldRotation = GetActorQuat();
+		const FVector NewLocation = FRepMovement::RebaseOntoLocalOrigin(ReplicatedExtMovement.Location, this);
+		const FQuat NewRotation = ReplicatedExtMovement.Rotation.Quaternion();
+
+		// Skip the teleport, overlap update and mesh smoothing when the proxy is already where the server says it is
+		if (FVector::DistSquared(OldLocation, NewLocation) > FMath::Square(ProxyReceiveLocationTolerance)
+			|| OldRotation.AngularDistance(NewRotation) > FMath::DegreesToRadians(ProxyReceiveRotationTolerance))
+		{
+			ExtCharacterMovement->bNetworkSmoothingComplete = false;
+			ExtCharacterMovement->bJustTeleported |= (OldLocation != NewLocation);
+			ExtCharacterMovement->SmoothCorrection(OldLocation, OldRotation, NewLocation, NewRotation);
+			OnUpdateSimulatedPosition(OldLocation, OldRotation);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_ExtCharacterExtMovementSkipped);
+		}
 	}
+
+	ExtCharacterMovement->bNetworkUpdateReceived = true;
+	ExtCharacterMovement->SetReplicatedAcceleration(ReplicatedExtMovement.bAccelerationDerived
+		? ExtCharacterMovement->DeriveAcceleration(ReplicatedExtMovement.Velocity, ReplicatedExtMovement.bAccelerationAlongVelocity)
+		: ReplicatedExtMovement.Acceleration);
+	ExtCharacterMovement->SetReplicatedPivotTurn(ReplicatedExtMovement.bIsPivotTurning);
+	if (ReplicatedExtMovement.bTurnInPlacePredicted)
+		ExtCharacterMovement->SetPredictedTurnInPlace();
+	else
+		ExtCharacterMovement->SetReplicatedTurnInPlace(ReplicatedExtMovement.TurnInPlaceTargetYaw);
 }
 
 void AExtCharacter::OnRep_ReplicatedExtMovementMode()
@@ -598,9 +906,83 @@ void AExtCharacter::OnRep_ReplicatedExtMovementMode()
 	GetCharacterMovement()->bNetworkMovementModeChanged = true;
 }
 
+uint16 AExtCharacter::PackReplicatedExtState(uint8 MovementModeAndJump) const
+{
+	return uint16(MovementModeAndJump)
+		| ((uint16(RotationMode) << ExtState::RotationModeShift) & ExtState::RotationModeMask)
+		| (bIsWalkingInsteadOfRunning ? ExtState::Walking : 0)
+		| (bIsSprinting ? ExtState::Sprinting : 0)
+		| (bIsPerformingGenericAction ? ExtState::PerformingGenericAction : 0);
+}
+
+void AExtCharacter::OnRep_ReplicatedExtState()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ExtCharacterOnRepExtState);
+
+	// Compare against the state currently applied rather than the previous replicated value so that the first update after the
+	// character becomes relevant dispatches everything that differs from the defaults
+	const uint16 ChangedBits = ReplicatedExtState ^ PackReplicatedExtState(ReplicatedExtMovementMode);
+	if (ChangedBits == 0)
+		return;
+
+	if (ChangedBits & ExtState::MovementModeMask)
+	{
+		ReplicatedExtMovementMode = uint8(ReplicatedExtState & ExtState::MovementModeMask);
+		OnRep_ReplicatedExtMovementMode();
+	}
+
+	if (ChangedBits & ExtState::RotationModeMask)
+	{
+		RotationMode = ECharacterRotationMode((ReplicatedExtState & ExtState::RotationModeMask) >> ExtState::RotationModeShift);
+		OnRotationModeChangedInternal();
+	}
+
+	if (ChangedBits & ExtState::Walking)
+	{
+		bIsWalkingInsteadOfRunning = (ReplicatedExtState & ExtState::Walking) != 0;
+		OnRep_IsWalkingInsteadOfRunning();
+	}
+
+	if (ChangedBits & ExtState::Sprinting)
+	{
+		bIsSprinting = (ReplicatedExtState & ExtState::Sprinting) != 0;
+		OnRep_IsSprinting();
+	}
+
+	if (ChangedBits & ExtState::PerformingGenericAction)
+	{
+		bIsPerformingGenericAction = (ReplicatedExtState & ExtState::PerformingGenericAction) != 0;
+		OnRep_IsPerformingGenericAction();
+	}
+}
+
 void AExtCharacter::OnRep_ReplicatedLook()
 {
 	RemoteViewPitch = (uint8)(ReplicatedLook.Rotation.Pitch * 255.f / 360.f);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (ProxyLookReceiveTime < 0.0f || LookSmoothingSpeed <= 0.0f)
+	{
+		// First update, nothing to smooth from
+		CurrentLookRotation = ReplicatedLook.Rotation;
+		ProxyLookAngularVelocity = FRotator::ZeroRotator;
+	}
+	else
+	{
+		// Updates are rate limited on the server so the elapsed time is never much smaller than the send interval
+		const float ElapsedTime = Now - ProxyLookReceiveTime;
+		ProxyLookAngularVelocity = (ElapsedTime > KINDA_SMALL_NUMBER && ElapsedTime <= LookPredictionMaxTime * 4.0f)
+			? (ReplicatedLook.Rotation - LastReceivedLookRotation).GetNormalized() * (1.0f / ElapsedTime)
+			: FRotator::ZeroRotator;
+	}
+
+	LastReceivedLookRotation = ReplicatedLook.Rotation;
+	ProxyLookReceiveTime = Now;
+}
+
+void AExtCharacter::OnRep_ReplicatedLookAt()
+{
+	ReplicatedLookAtActor = ReplicatedLookAt.Actor;
 }
 
 void AExtCharacter::OnRep_IsWalkingInsteadOfRunning()
@@ -756,6 +1138,9 @@ void AExtCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (GetLocalRole() == ROLE_SimulatedProxy)
+		UpdateProxyLook(DeltaTime);
+
 #if WITH_EDITOR
 
 	UpdateDebugComponentsVisibility();
@@ -954,6 +1339,10 @@ void AExtCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompon
 {
 	Super::SetupPlayerInputComponent(PlayerInputComponent);
 
+	InputState = FExtCharacterInputState();
+	AppliedInputIntents = FExtCharacterInputState();
+	bGenericActionPressLatched = false;
+
 	PlayerInputComponent->BindAxis(MoveForwardAxisName, this, &ThisClass::PlayerInputMoveForward);
 	PlayerInputComponent->BindAxis(MoveRightAxisName, this, &ThisClass::PlayerInputMoveRight);
 
@@ -978,6 +1367,8 @@ void AExtCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompon
 
 void AExtCharacter::PlayerInputMoveForward(float Value)
 {
+	InputState.MoveForward = Value;
+
 	if (Value != 0.0f && Controller && Controller->IsLocalPlayerController())
 	{
 		FVector Location;
@@ -989,6 +1380,8 @@ void AExtCharacter::PlayerInputMoveForward(float Value)
 
 void AExtCharacter::PlayerInputMoveRight(float Value)
 {
+	InputState.MoveRight = Value;
+
 	if (Value != 0.0f && Controller && Controller->IsLocalPlayerController())
 	{
 		FVector Location;
@@ -1000,6 +1393,8 @@ void AExtCharacter::PlayerInputMoveRight(float Value)
 
 void AExtCharacter::PlayerInputLookUp(float Value)
 {
+	InputState.LookUp = Value;
+
 	if (Value != 0.0f && Controller && Controller->IsLocalPlayerController())
 	{
 		AddControllerPitchInput(LookUpInputSpeed > 0.0f ? LookUpInputSpeed * GetWorld()->GetDeltaSeconds() * Value : Value);
@@ -1008,6 +1403,8 @@ void AExtCharacter::PlayerInputLookUp(float Value)
 
 void AExtCharacter::PlayerInputLookRight(float Value)
 {
+	InputState.LookRight = Value;
+
 	if (Value != 0.0f && Controller && Controller->IsLocalPlayerController())
 	{
 		AddControllerYawInput(LookRightInputSpeed > 0.0f ? LookRightInputSpeed * GetWorld()->GetDeltaSeconds() * Value : Value);
@@ -1016,7 +1413,10 @@ void AExtCharacter::PlayerInputLookRight(float Value)
 
 void AExtCharacter::PlayerInputStartCrouch()
 {
-	if (Controller && Controller->IsLocalPlayerController())
+	InputState.bCrouchPressed = true;
+	INC_DWORD_STAT(STAT_ExtCharacterInputIntents);
+
+	if (!bBufferInputIntents && Controller && Controller->IsLocalPlayerController())
 	{
 		Crouch();
 	}
@@ -1024,7 +1424,10 @@ void AExtCharacter::PlayerInputStartCrouch()
 
 void AExtCharacter::PlayerInputStopCrouch()
 {
-	if (Controller && Controller->IsLocalPlayerController())
+	InputState.bCrouchPressed = false;
+	INC_DWORD_STAT(STAT_ExtCharacterInputIntents);
+
+	if (!bBufferInputIntents && Controller && Controller->IsLocalPlayerController())
 	{
 		UnCrouch();
 	}
@@ -1032,6 +1435,8 @@ void AExtCharacter::PlayerInputStopCrouch()
 
 void AExtCharacter::PlayerInputStartJump()
 {
+	InputState.bJumpPressed = true;
+
 	if (Controller && Controller->IsLocalPlayerController())
 	{
 		if (!bIsRagdoll || !bIgnoreMoveInputWhenRagdoll)
@@ -1041,6 +1446,8 @@ void AExtCharacter::PlayerInputStartJump()
 
 void AExtCharacter::PlayerInputStopJump()
 {
+	InputState.bJumpPressed = false;
+
 	if (Controller && Controller->IsLocalPlayerController())
 	{
 		if (!bIsRagdoll || !bIgnoreMoveInputWhenRagdoll)
@@ -1050,7 +1457,10 @@ void AExtCharacter::PlayerInputStopJump()
 
 void AExtCharacter::PlayerInputStartWalk()
 {
-	if (Controller && Controller->IsLocalPlayerController())
+	InputState.bWalkPressed = true;
+	INC_DWORD_STAT(STAT_ExtCharacterInputIntents);
+
+	if (!bBufferInputIntents && Controller && Controller->IsLocalPlayerController())
 	{
 		Walk();
 	}
@@ -1058,7 +1468,10 @@ void AExtCharacter::PlayerInputStartWalk()
 
 void AExtCharacter::PlayerInputStopWalk()
 {
-	if (Controller && Controller->IsLocalPlayerController())
+	InputState.bWalkPressed = false;
+	INC_DWORD_STAT(STAT_ExtCharacterInputIntents);
+
+	if (!bBufferInputIntents && Controller && Controller->IsLocalPlayerController())
 	{
 		UnWalk();
 	}
@@ -1066,7 +1479,10 @@ void AExtCharacter::PlayerInputStopWalk()
 
 void AExtCharacter::PlayerInputStartSprint()
 {
-	if (Controller && Controller->IsLocalPlayerController())
+	InputState.bSprintPressed = true;
+	INC_DWORD_STAT(STAT_ExtCharacterInputIntents);
+
+	if (!bBufferInputIntents && Controller && Controller->IsLocalPlayerController())
 	{
 		Sprint();
 	}
@@ -1074,7 +1490,10 @@ void AExtCharacter::PlayerInputStartSprint()
 
 void AExtCharacter::PlayerInputStopSprint()
 {
-	if (Controller && Controller->IsLocalPlayerController())
+	InputState.bSprintPressed = false;
+	INC_DWORD_STAT(STAT_ExtCharacterInputIntents);
+
+	if (!bBufferInputIntents && Controller && Controller->IsLocalPlayerController())
 	{
 		UnSprint();
 	}
@@ -1082,7 +1501,11 @@ void AExtCharacter::PlayerInputStopSprint()
 
 void AExtCharacter::PlayerInputStartGenericAction()
 {
-	if (Controller && Controller->IsLocalPlayerController())
+	InputState.bGenericActionPressed = true;
+	bGenericActionPressLatched = true;
+	INC_DWORD_STAT(STAT_ExtCharacterInputIntents);
+
+	if (!bBufferInputIntents && Controller && Controller->IsLocalPlayerController())
 	{
 		PerformGenericAction();
 	}
@@ -1090,12 +1513,110 @@ void AExtCharacter::PlayerInputStartGenericAction()
 
 void AExtCharacter::PlayerInputStopGenericAction()
 {
-	if (Controller && Controller->IsLocalPlayerController())
+	InputState.bGenericActionPressed = false;
+	INC_DWORD_STAT(STAT_ExtCharacterInputIntents);
+
+	if (!bBufferInputIntents && Controller && Controller->IsLocalPlayerController())
 	{
 		UnPerformGenericAction();
 	}
 }
 
+void AExtCharacter::ApplyInputIntents()
+{
+	if (!bBufferInputIntents || !Controller || !Controller->IsLocalPlayerController())
+		return;
+
+	int32 NumTransitions = 0;
+
+	if (AppliedInputIntents.bCrouchPressed != InputState.bCrouchPressed)
+	{
+		AppliedInputIntents.bCrouchPressed = InputState.bCrouchPressed;
+		InputState.bCrouchPressed ? Crouch() : UnCrouch();
+		++NumTransitions;
+	}
+
+	if (AppliedInputIntents.bWalkPressed != InputState.bWalkPressed)
+	{
+		AppliedInputIntents.bWalkPressed = InputState.bWalkPressed;
+		InputState.bWalkPressed ? Walk() : UnWalk();
+		++NumTransitions;
+	}
+
+	if (AppliedInputIntents.bSprintPressed != InputState.bSprintPressed)
+	{
+		AppliedInputIntents.bSprintPressed = InputState.bSprintPressed;
+		InputState.bSprintPressed ? Sprint() : UnSprint();
+		++NumTransitions;
+	}
+
+	// A press released within the same frame is still applied, and the release waits for the next frame
+	if (bGenericActionPressLatched && !AppliedInputIntents.bGenericActionPressed)
+	{
+		AppliedInputIntents.bGenericActionPressed = true;
+		PerformGenericAction();
+		++NumTransitions;
+	}
+	else if (AppliedInputIntents.bGenericActionPressed != InputState.bGenericActionPressed)
+	{
+		AppliedInputIntents.bGenericActionPressed = InputState.bGenericActionPressed;
+		InputState.bGenericActionPressed ? PerformGenericAction() : UnPerformGenericAction();
+		++NumTransitions;
+	}
+	bGenericActionPressLatched = false;
+
+	if (NumTransitions > 0)
+	{
+		INC_DWORD_STAT_BY(STAT_ExtCharacterInputIntentTransitions, NumTransitions);
+		GInputIntentTransitionsInWindow += NumTransitions;
+	}
+
+#if STATS
+	// Shared by all local characters so split screen players add up
+	const double Now = FPlatformTime::Seconds();
+	if (Now - GInputIntentWindowStartTime >= 1.0)
+	{
+		SET_DWORD_STAT(STAT_ExtCharacterInputIntentTransitionsPerSecond, FMath::RoundToInt(GInputIntentTransitionsInWindow / (Now - GInputIntentWindowStartTime)));
+		GInputIntentWindowStartTime = Now;
+		GInputIntentTransitionsInWindow = 0;
+	}
+#endif
+}
+
+
+/// Look
+
+void AExtCharacter::UpdateReplicatedLook()
+{
+	const FRotator Delta = (CurrentLookRotation - ReplicatedLook.Rotation).GetNormalized();
+	if (FMath::Abs(Delta.Yaw) <= LookReplicationDeadBand && FMath::Abs(Delta.Pitch) <= LookReplicationDeadBand)
+		return;
+
+	// Skipped updates are picked up by the next movement update once the interval has passed
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (LookReplicationMaxRate > 0.0f && Now - LastLookReplicationTime < 1.0f / LookReplicationMaxRate)
+	{
+		INC_DWORD_STAT(STAT_ExtCharacterLookReplicationSkipped);
+		return;
+	}
+
+	ReplicatedLook.Rotation = CurrentLookRotation;
+	LastLookReplicationTime = Now;
+	INC_DWORD_STAT(STAT_ExtCharacterLookReplicationUpdates);
+}
+
+void AExtCharacter::UpdateProxyLook(float DeltaSeconds)
+{
+	if (ProxyLookReceiveTime < 0.0f || LookSmoothingSpeed <= 0.0f)
+		return;
+
+	const float PredictionTime = FMath::Min(GetWorld()->GetTimeSeconds() - ProxyLookReceiveTime, LookPredictionMaxTime);
+	FRotator TargetRotation = LastReceivedLookRotation + ProxyLookAngularVelocity * PredictionTime;
+	TargetRotation.Pitch = FMath::ClampAngle(TargetRotation.Pitch, -90.0f, 90.0f);
+
+	CurrentLookRotation = FMath::RInterpTo(CurrentLookRotation, TargetRotation.GetNormalized(), DeltaSeconds, LookSmoothingSpeed);
+}
+
 
 /// Movement Handlers
 
@@ -1108,7 +1629,9 @@ void AExtCharacter::OnUpdateAfterMovement(float DeltaSeconds)
 {
 	checkActorRoleAtLeast(ROLE_AutonomousProxy);
 
-	ReplicatedLook.Rotation = GetControlRotation();
+	CurrentLookRotation = GetControlRotation();
+	if (GetLocalRole() == ROLE_Authority)
+		UpdateReplicatedLook();
 
 	UExtCharacterMovementComponent* ExtCharacterMovement = GetExtCharacterMovement();
 	check(ExtCharacterMovement);
@@ -1268,7 +1791,11 @@ void AExtCharacter::OnRotationModeChangedInternal()
 	}
 
 	OnRotationModeChanged();
-	RotationModeChangedDelegate.Broadcast(this);
+
+	SCOPE_CYCLE_COUNTER(STAT_ExtCharacterBroadcastRotationModeChanged);
+	RotationModeChangedNativeDelegate.Broadcast(this);
+	if (RotationModeChangedDelegate.IsBound())
+		RotationModeChangedDelegate.Broadcast(this);
 }
 
 void AExtCharacter::OnRotationModeChanged()
@@ -1439,7 +1966,11 @@ void AExtCharacter::OnEndCrouch(float HalfHeightAdjust, float ScaledHalfHeightAd
 	Super::OnEndCrouch(HalfHeightAdjust, ScaledHalfHeightAdjust);
 
 	OnCrouchedChanged();
-	CrouchChangedDelegate.Broadcast(this);
+
+	SCOPE_CYCLE_COUNTER(STAT_ExtCharacterBroadcastCrouchChanged);
+	CrouchChangedNativeDelegate.Broadcast(this);
+	if (CrouchChangedDelegate.IsBound())
+		CrouchChangedDelegate.Broadcast(this);
 }
 
 void AExtCharacter::OnStartCrouch(float HalfHeightAdjust, float ScaledHalfHeightAdjust)
@@ -1447,7 +1978,11 @@ void AExtCharacter::OnStartCrouch(float HalfHeightAdjust, float ScaledHalfHeight
 	Super::OnStartCrouch(HalfHeightAdjust, ScaledHalfHeightAdjust);
 
 	OnCrouchedChanged();
-	CrouchChangedDelegate.Broadcast(this);
+
+	SCOPE_CYCLE_COUNTER(STAT_ExtCharacterBroadcastCrouchChanged);
+	CrouchChangedNativeDelegate.Broadcast(this);
+	if (CrouchChangedDelegate.IsBound())
+		CrouchChangedDelegate.Broadcast(this);
 }
 
 
@@ -1634,7 +2169,11 @@ void AExtCharacter::OnEndGenericAction()
 	K2_OnEndGenericAction();
 
 	OnPerformingGenericActionChanged();
-	GenericActionChangedDelegate.Broadcast(this);
+
+	SCOPE_CYCLE_COUNTER(STAT_ExtCharacterBroadcastGenericActionChanged);
+	GenericActionChangedNativeDelegate.Broadcast(this);
+	if (GenericActionChangedDelegate.IsBound())
+		GenericActionChangedDelegate.Broadcast(this);
 }
 
 void AExtCharacter::OnStartGenericAction()
@@ -1642,12 +2181,19 @@ void AExtCharacter::OnStartGenericAction()
 	K2_OnStartGenericAction();
 
 	OnPerformingGenericActionChanged();
-	GenericActionChangedDelegate.Broadcast(this);
+
+	SCOPE_CYCLE_COUNTER(STAT_ExtCharacterBroadcastGenericActionChanged);
+	GenericActionChangedNativeDelegate.Broadcast(this);
+	if (GenericActionChangedDelegate.IsBound())
+		GenericActionChangedDelegate.Broadcast(this);
 }
 
 void AExtCharacter::MulticastPlayHitReact_Implementation(ECardinalDirection HitDirection, AActor* DamageCauser)
 {
-	HitReactDelegate.Broadcast(this, HitDirection, DamageCauser);
+	SCOPE_CYCLE_COUNTER(STAT_ExtCharacterBroadcastHitReact);
+	HitReactNativeDelegate.Broadcast(this, HitDirection, DamageCauser);
+	if (HitReactDelegate.IsBound())
+		HitReactDelegate.Broadcast(this, HitDirection, DamageCauser);
 }
 
 
@@ -1723,7 +2269,11 @@ void AExtCharacter::OnEndRagdoll()
 
 	K2_OnEndRagdoll();
 	OnRagdollChanged();
-	RagdollChangedDelegate.Broadcast(this);
+
+	SCOPE_CYCLE_COUNTER(STAT_ExtCharacterBroadcastRagdollChanged);
+	RagdollChangedNativeDelegate.Broadcast(this);
+	if (RagdollChangedDelegate.IsBound())
+		RagdollChangedDelegate.Broadcast(this);
 }
 
 void AExtCharacter::OnStartRagdoll()
@@ -1811,7 +2361,11 @@ void AExtCharacter::OnStartRagdoll()
 
 	K2_OnStartRagdoll();
 	OnRagdollChanged();
-	RagdollChangedDelegate.Broadcast(this);
+
+	SCOPE_CYCLE_COUNTER(STAT_ExtCharacterBroadcastRagdollChanged);
+	RagdollChangedNativeDelegate.Broadcast(this);
+	if (RagdollChangedDelegate.IsBound())
+		RagdollChangedDelegate.Broadcast(this);
 }
 
 
@@ -1865,7 +2419,11 @@ void AExtCharacter::SetGait(ECharacterGait NewGait)
 	{
 		Gait = NewGait;
 		OnGaitChanged();
-		GaitChangedDelegate.Broadcast(this);
+
+		SCOPE_CYCLE_COUNTER(STAT_ExtCharacterBroadcastGaitChanged);
+		GaitChangedNativeDelegate.Broadcast(this);
+		if (GaitChangedDelegate.IsBound())
+			GaitChangedDelegate.Broadcast(this);
 	}
 }
 
@@ -1900,6 +2458,49 @@ void AExtCharacter::SetLookAtActor(AActor* InActor)
 		SetLookAtActor(InActor);
 }
 
+bool AExtCharacter::GetLookAtLocation(FVector& OutLocation) const
+{
+	if (IsValid(ReplicatedLookAtActor))
+	{
+		OutLocation = ReplicatedLookAtActor->GetTargetLocation(const_cast<AExtCharacter*>(this));
+		return true;
+	}
+
+	// Actor not relevant to this client, use the location sent instead
+	if (bRelevancyAwareLookAt && GetLocalRole() == ROLE_SimulatedProxy && ReplicatedLookAt.bHasTarget)
+	{
+		OutLocation = ReplicatedLookAt.Location;
+		return true;
+	}
+
+	return false;
+}
+
+void AExtCharacter::UpdateReplicatedLookAt()
+{
+	AActor* LookAtActor = IsValid(ReplicatedLookAtActor) ? ReplicatedLookAtActor : nullptr;
+	if (!LookAtActor)
+	{
+		ReplicatedLookAt = FRepLookAt();
+		return;
+	}
+
+	const bool bTargetChanged = ReplicatedLookAt.Actor != LookAtActor;
+	const FVector Location = LookAtActor->GetTargetLocation(this);
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	// Changing the location makes the struct replicate again to everyone, so location only changes are rate limited
+	if (bTargetChanged
+		|| (Now - LastLookAtLocationUpdateTime >= (LookAtLocationUpdateRate > 0.0f ? 1.0f / LookAtLocationUpdateRate : 0.0f)
+			&& FVector::DistSquared(Location, ReplicatedLookAt.Location) > FMath::Square(LookAtLocationTolerance)))
+	{
+		ReplicatedLookAt.Actor = LookAtActor;
+		ReplicatedLookAt.Location = Location;
+		ReplicatedLookAt.bHasTarget = true;
+		LastLookAtLocationUpdateTime = Now;
+	}
+}
+
 void AExtCharacter::SetRotationMode(ECharacterRotationMode Value)
 {
 	checkActorRoleAtLeast(ROLE_AutonomousProxy);
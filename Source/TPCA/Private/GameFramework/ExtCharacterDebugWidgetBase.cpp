@@ -45,12 +45,12 @@ void UExtCharacterDebugWidgetBase::OnWidgetComponentChanged(UActorWidgetComponen
 {
 	if (ExtCharacterOwner)
 	{
-		ExtCharacterOwner->CrouchChangedDelegate.RemoveDynamic(this, &UExtCharacterDebugWidgetBase::HandleCrouchChanged);
-		ExtCharacterOwner->GenericActionChangedDelegate.RemoveDynamic(this, &UExtCharacterDebugWidgetBase::HandleGenericActionChanged);
-		ExtCharacterOwner->GaitChangedDelegate.RemoveDynamic(this, &UExtCharacterDebugWidgetBase::HandleGaitChanged);
-		ExtCharacterOwner->RotationModeChangedDelegate.RemoveDynamic(this, &UExtCharacterDebugWidgetBase::HandleRotationModeChanged);
+		ExtCharacterOwner->CrouchChangedNativeDelegate.RemoveAll(this);
+		ExtCharacterOwner->GenericActionChangedNativeDelegate.RemoveAll(this);
+		ExtCharacterOwner->GaitChangedNativeDelegate.RemoveAll(this);
+		ExtCharacterOwner->RotationModeChangedNativeDelegate.RemoveAll(this);
 		ExtCharacterOwner->MovementModeChangedDelegate.RemoveDynamic(this, &UExtCharacterDebugWidgetBase::HandleMovementModeChanged);
-		ExtCharacterOwner->RagdollChangedDelegate.RemoveDynamic(this, &UExtCharacterDebugWidgetBase::HandleRagdollChanged);
+		ExtCharacterOwner->RagdollChangedNativeDelegate.RemoveAll(this);
 
 		ExtCharacterOwner = nullptr;
 	}
@@ -62,12 +62,12 @@ void UExtCharacterDebugWidgetBase::OnWidgetComponentChanged(UActorWidgetComponen
 		ExtCharacterOwner = Cast<AExtCharacter>(NewWidgetComponent->GetOwner());
 		if (ExtCharacterOwner)
 		{
-			ExtCharacterOwner->CrouchChangedDelegate.AddDynamic(this, &UExtCharacterDebugWidgetBase::HandleCrouchChanged);
-			ExtCharacterOwner->GenericActionChangedDelegate.AddDynamic(this, &UExtCharacterDebugWidgetBase::HandleGenericActionChanged);
-			ExtCharacterOwner->GaitChangedDelegate.AddDynamic(this, &UExtCharacterDebugWidgetBase::HandleGaitChanged);
-			ExtCharacterOwner->RotationModeChangedDelegate.AddDynamic(this, &UExtCharacterDebugWidgetBase::HandleRotationModeChanged);
+			ExtCharacterOwner->CrouchChangedNativeDelegate.AddUObject(this, &UExtCharacterDebugWidgetBase::HandleCrouchChanged);
+			ExtCharacterOwner->GenericActionChangedNativeDelegate.AddUObject(this, &UExtCharacterDebugWidgetBase::HandleGenericActionChanged);
+			ExtCharacterOwner->GaitChangedNativeDelegate.AddUObject(this, &UExtCharacterDebugWidgetBase::HandleGaitChanged);
+			ExtCharacterOwner->RotationModeChangedNativeDelegate.AddUObject(this, &UExtCharacterDebugWidgetBase::HandleRotationModeChanged);
 			ExtCharacterOwner->MovementModeChangedDelegate.AddDynamic(this, &UExtCharacterDebugWidgetBase::HandleMovementModeChanged);
-			ExtCharacterOwner->RagdollChangedDelegate.AddDynamic(this, &UExtCharacterDebugWidgetBase::HandleRagdollChanged);
+			ExtCharacterOwner->RagdollChangedNativeDelegate.AddUObject(this, &UExtCharacterDebugWidgetBase::HandleRagdollChanged);
 
 			HandleCrouchChanged(ExtCharacterOwner);
 			HandleGenericActionChanged(ExtCharacterOwner);
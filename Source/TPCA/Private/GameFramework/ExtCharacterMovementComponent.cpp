@@ -3,7 +3,9 @@
 #include "GameFramework/ExtCharacterMovementComponent.h"
 #include "GameFramework/ExtCharacter.h"
 #include "GameFramework/Controller.h"
+#include "GameFramework/PlayerController.h"
 #include "GameFramework/PhysicsVolume.h"
+#include "GameFramework/ServerMoveQueueSubsystem.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/SkeletalMeshComponent.h"
 #include "Animation/AnimInstance.h"
@@ -11,10 +13,14 @@
 #include "AI/Navigation/AvoidanceManager.h"
 #include "Net/UnrealNetwork.h"
 #include "Engine/NetworkObjectList.h"
+#include "Engine/World.h"
 #include "PhysicsEngine/ConstraintInstance.h"
 #include "Curves/CurveFloat.h"
 #include "GenericTeamAgentInterface.h"
 #include "EngineStats.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/Histogram.h"
 
 #include "Math/MathExtensions.h"
 #include "Kismet/Kismet.h"
@@ -27,6 +33,26 @@ DEFINE_LOG_CATEGORY_STATIC(LogExtCharacterMovement, Log, All);
 DECLARE_CYCLE_STAT(TEXT("Char PerformMovement"), STAT_CharacterMovementPerformMovement, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char RootMotionSource Calculate"), STAT_CharacterMovementRootMotionSourceCalculate, STATGROUP_Character);
 DECLARE_CYCLE_STAT(TEXT("Char RootMotionSource Apply"), STAT_CharacterMovementRootMotionSourceApply, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char Update Smoothing LOD"), STAT_CharacterMovementUpdateSmoothingLOD, STATGROUP_Character);
+DECLARE_CYCLE_STAT(TEXT("Char Predict Proxy TurnInPlace"), STAT_CharacterMovementPredictProxyTurnInPlace, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Proxies Smoothing Exponential"), STAT_CharacterMovementProxiesSmoothingExponential, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Proxies Smoothing Linear"), STAT_CharacterMovementProxiesSmoothingLinear, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Proxies Smoothing Disabled"), STAT_CharacterMovementProxiesSmoothingDisabled, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Proxies At Rest"), STAT_CharacterMovementProxiesAtRest, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Server Moves Queued"), STAT_CharacterMovementServerMovesQueued, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Server Moves Combined"), STAT_CharacterMovementServerMovesCombined, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Server Moves Over Queue Limit"), STAT_CharacterMovementServerMovesOverQueueLimit, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Client Corrections"), STAT_CharacterMovementClientCorrections, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Client Correction Moves Replayed"), STAT_CharacterMovementClientCorrectionMovesReplayed, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Client Corrections Gait Differed"), STAT_CharacterMovementClientCorrectionsGaitDiffered, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Client Corrections TurnInPlace Differed"), STAT_CharacterMovementClientCorrectionsTurnInPlaceDiffered, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Client Corrections PivotTurn Differed"), STAT_CharacterMovementClientCorrectionsPivotTurnDiffered, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Client Corrections RotationMode Differed"), STAT_CharacterMovementClientCorrectionsRotationModeDiffered, STATGROUP_Character);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Char Client Correction Error"), STAT_CharacterMovementClientCorrectionError, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Client Corrections Per Second"), STAT_CharacterMovementClientCorrectionsPerSecond, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Char Client Moves Replayed Per Second"), STAT_CharacterMovementClientMovesReplayedPerSecond, STATGROUP_Character);
+
+CSV_DEFINE_CATEGORY(ExtCharacterCorrections, true);
 
 // Defines for build configs
 #if DO_CHECK && !UE_BUILD_SHIPPING // Disable even if checks in shipping are enabled.
@@ -35,6 +61,78 @@ DECLARE_CYCLE_STAT(TEXT("Char RootMotionSource Apply"), STAT_CharacterMovementRo
 	#define devCode(...)
 #endif
 
+/** Client correction diagnostics shared by all local characters so split screen players add up. */
+struct FExtCorrectionDiagnostics
+{
+	FHistogram PositionErrorHistogram;
+	FHistogram MovesReplayedHistogram;
+	int32 NumCorrections;
+	int32 NumMovesReplayed;
+	int32 NumWithoutExtState;
+	int32 NumGaitDiffered;
+	int32 NumTurnInPlaceDiffered;
+	int32 NumPivotTurnDiffered;
+	int32 NumRotationModeDiffered;
+	double WindowStartTime;
+	int32 CorrectionsInWindow;
+	int32 MovesReplayedInWindow;
+
+	FExtCorrectionDiagnostics()
+	{
+		Reset();
+	}
+
+	void Reset()
+	{
+		PositionErrorHistogram.InitLinear(0.0, 100.0, 5.0);
+		MovesReplayedHistogram.InitLinear(0.0, 64.0, 4.0);
+		NumCorrections = 0;
+		NumMovesReplayed = 0;
+		NumWithoutExtState = 0;
+		NumGaitDiffered = 0;
+		NumTurnInPlaceDiffered = 0;
+		NumPivotTurnDiffered = 0;
+		NumRotationModeDiffered = 0;
+		WindowStartTime = FPlatformTime::Seconds();
+		CorrectionsInWindow = 0;
+		MovesReplayedInWindow = 0;
+	}
+
+	/** Publish the per second rates once the window has run for a second, including windows without corrections. */
+	void UpdateRateWindow()
+	{
+		const double Now = FPlatformTime::Seconds();
+		if (Now - WindowStartTime >= 1.0)
+		{
+			const double WindowLength = Now - WindowStartTime;
+			SET_DWORD_STAT(STAT_CharacterMovementClientCorrectionsPerSecond, FMath::RoundToInt(CorrectionsInWindow / WindowLength));
+			SET_DWORD_STAT(STAT_CharacterMovementClientMovesReplayedPerSecond, FMath::RoundToInt(MovesReplayedInWindow / WindowLength));
+			WindowStartTime = Now;
+			CorrectionsInWindow = 0;
+			MovesReplayedInWindow = 0;
+		}
+	}
+};
+
+/** Cycles spent simulating proxies, shared by all characters. */
+static uint64 GProxySimulationCycles = 0;
+
+static FExtCorrectionDiagnostics& GetCorrectionDiagnostics()
+{
+	static FExtCorrectionDiagnostics CorrectionDiagnostics;
+	return CorrectionDiagnostics;
+}
+
+static FAutoConsoleCommand CmdDumpCorrectionDiagnostics(
+	TEXT("p.ExtCharacter.DumpCorrectionDiagnostics"),
+	TEXT("Log the client correction histograms and counters recorded by characters with bRecordCorrectionDiagnostics."),
+	FConsoleCommandDelegate::CreateStatic(&UExtCharacterMovementComponent::DumpCorrectionDiagnostics));
+
+static FAutoConsoleCommand CmdResetCorrectionDiagnostics(
+	TEXT("p.ExtCharacter.ResetCorrectionDiagnostics"),
+	TEXT("Clear the client correction histograms and counters."),
+	FConsoleCommandDelegate::CreateStatic(&UExtCharacterMovementComponent::ResetCorrectionDiagnostics));
+
 FORCEINLINE static int32 GetCVarNetEnableSkipProxyPredictionOnNetUpdate()
 {
 	static const auto CVar = IConsoleManager::Get().FindConsoleVariable(TEXT("p.NetEnableSkipProxyPredictionOnNetUpdate"));
@@ -153,6 +251,10 @@ UExtCharacterMovementComponent::UExtCharacterMovementComponent(const FObjectInit
 	TurnInPlaceSlowThreshold = 15.0f;
 	TurnInPlaceMaxDistance = 90.0f;
 	TurnInPlaceTargetYaw = INFINITY;
+	bPredictProxyTurnInPlace = false;
+	ProxyTurnInPlaceStepMargin = 10.0f;
+	bTurnInPlaceStepAmbiguous = false;
+	bProxyPredictingTurnInPlace = false;
 
 	// Walk Off Ledges
 	bCanWalkOffLedgesWhenCrouching = true;
@@ -173,6 +275,29 @@ UExtCharacterMovementComponent::UExtCharacterMovementComponent(const FObjectInit
 	AvoidanceRadius = 0.0f;
 	AvoidanceDirectionLagSpeed = 0.0f;
 	AvoidanceMagnitudeLagSpeed = 0.0f;
+
+	// Proxy Smoothing LOD
+	bEnableSmoothingLOD = true;
+	bSkipSimulationAtRest = true;
+	SmoothingLODLinearDistance = 1500.0f;
+	SmoothingLODDisabledDistance = 4000.0f;
+	SmoothingLODUpdateInterval = 0.25f;
+	bDeriveProxyAcceleration = true;
+	DerivedAccelerationMaxError = 0.25f;
+	DerivedAccelerationVelocityTolerance = 10.0f;
+	SmoothingLODTimeCounter = 0.0f;
+	SmoothingSignificance = 1.0f;
+	MaxNetworkSmoothingMode = NetworkSmoothingMode;
+	PendingNetworkSmoothingMode = NetworkSmoothingMode;
+
+	// Server Move Queue
+	bQueueServerMoves = true;
+	bCombineQueuedServerMoves = false;
+
+	// Correction Diagnostics
+	bRecordCorrectionDiagnostics = false;
+	CorrectionResponse = nullptr;
+	SetMoveResponseDataContainer(ExtMoveResponseDataContainer);
 }
 
 #if WITH_EDITOR
@@ -220,13 +345,27 @@ void UExtCharacterMovementComponent::BeginPlay()
 
 	ResetMoveState();
 	ResetExtraMoveState();
+
+	MaxNetworkSmoothingMode = NetworkSmoothingMode;
+	PendingNetworkSmoothingMode = NetworkSmoothingMode;
+
+	// Spread smoothing LOD updates of proxies spawned on the same frame
+	SmoothingLODTimeCounter = FMath::FRand() * SmoothingLODUpdateInterval;
 }
 
 
 void UExtCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction)
 {
+	// Buffered input must be applied before the move is saved so the saved move flags match the movement performed
+	if (ExtCharacterOwner && ExtCharacterOwner->IsLocallyControlled())
+		ExtCharacterOwner->ApplyInputIntents();
+
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	// Rates are published from the tick so they drop back to zero when no corrections arrive
+	if (bRecordCorrectionDiagnostics && GetOwnerRole() == ROLE_AutonomousProxy)
+		GetCorrectionDiagnostics().UpdateRateWindow();
+
 #if WITH_EDITOR
 	TurnInPlaceTargetYawDisplayText = FMath::IsFinite(TurnInPlaceTargetYaw) ? FString::SanitizeFloat(TurnInPlaceTargetYaw) :
 		(TurnInPlaceTargetYaw > 0.f) ? NAME_TurnInPlaceTargetYaw_None.ToString() : NAME_TurnInPlaceTargetYaw_Suspended.ToString();
@@ -261,6 +400,16 @@ void UExtCharacterMovementComponent::SetReplicatedAcceleration(const FVector& Va
 	SimulatedAcceleration = Value;
 }
 
+FVector UExtCharacterMovementComponent::DeriveAcceleration(const FVector& ReplicatedVelocity, bool bAlongVelocity) const
+{
+	// Only the direction is replicated so MaxAcceleration does not matter
+	const FVector Velocity2D(ReplicatedVelocity.X, ReplicatedVelocity.Y, 0.f);
+	if (!bAlongVelocity || Velocity2D.SizeSquared() <= FMath::Square(DerivedAccelerationVelocityTolerance))
+		return FVector::ZeroVector;
+
+	return Velocity2D.GetSafeNormal();
+}
+
 void UExtCharacterMovementComponent::SetReplicatedPivotTurn(bool bInIsPivotTurning)
 {
 	checkActorRoleExactly(ROLE_SimulatedProxy);
@@ -273,6 +422,338 @@ void UExtCharacterMovementComponent::SetReplicatedTurnInPlace(float InTurnInPlac
 	checkActorRoleExactly(ROLE_SimulatedProxy);
 
 	TurnInPlaceTargetYaw = InTurnInPlaceTargetYaw;
+	bProxyPredictingTurnInPlace = false;
+}
+
+void UExtCharacterMovementComponent::SetPredictedTurnInPlace()
+{
+	checkActorRoleExactly(ROLE_SimulatedProxy);
+
+	bProxyPredictingTurnInPlace = true;
+}
+
+bool UExtCharacterMovementComponent::CanProxyPredictTurnInPlace() const
+{
+	return bPredictProxyTurnInPlace && !bTurnInPlaceStepAmbiguous;
+}
+
+void UExtCharacterMovementComponent::SetSmoothingSignificance(float Value)
+{
+	SmoothingSignificance = FMath::Max(Value, 0.0f);
+}
+
+void UExtCharacterMovementComponent::SimulatedTick(float DeltaSeconds)
+{
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	if (CharacterOwner && CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		UpdateSmoothingLOD(DeltaSeconds);
+
+		if (bPredictProxyTurnInPlace && bProxyPredictingTurnInPlace && ExtCharacterOwner)
+			PredictProxyTurnInPlace(DeltaSeconds);
+
+		switch (NetworkSmoothingMode)
+		{
+			case ENetworkSmoothingMode::Exponential: INC_DWORD_STAT(STAT_CharacterMovementProxiesSmoothingExponential); break;
+			case ENetworkSmoothingMode::Linear: INC_DWORD_STAT(STAT_CharacterMovementProxiesSmoothingLinear); break;
+			case ENetworkSmoothingMode::Disabled: INC_DWORD_STAT(STAT_CharacterMovementProxiesSmoothingDisabled); break;
+			default: break;
+		}
+	}
+
+	// Mesh smoothing is already skipped by the engine once bNetworkSmoothingComplete is set
+	Super::SimulatedTick(DeltaSeconds);
+
+	GProxySimulationCycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+void UExtCharacterMovementComponent::UpdateSmoothingLOD(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementUpdateSmoothingLOD);
+
+	if (!bEnableSmoothingLOD || MaxNetworkSmoothingMode == ENetworkSmoothingMode::Replay)
+		return;
+
+	SmoothingLODTimeCounter -= DeltaSeconds;
+	if (SmoothingLODTimeCounter <= 0.0f)
+	{
+		SmoothingLODTimeCounter = SmoothingLODUpdateInterval;
+		PendingNetworkSmoothingMode = ComputeSmoothingLOD();
+	}
+
+	// Switching modes in the middle of a correction would leave the mesh offset of the previous mode behind
+	if (PendingNetworkSmoothingMode != NetworkSmoothingMode && bNetworkSmoothingComplete)
+		NetworkSmoothingMode = PendingNetworkSmoothingMode;
+}
+
+ENetworkSmoothingMode UExtCharacterMovementComponent::ComputeSmoothingLOD() const
+{
+	const USkeletalMeshComponent* Mesh = CharacterOwner->GetMesh();
+	if (!Mesh || !Mesh->WasRecentlyRendered(SmoothingLODUpdateInterval))
+		return ENetworkSmoothingMode::Disabled;
+
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+	float MinDistanceSquared = BIG_NUMBER;
+	for (FConstPlayerControllerIterator Iterator = GetWorld()->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (PlayerController && PlayerController->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(Location, ViewLocation));
+		}
+	}
+
+	// No local view to measure against
+	if (MinDistanceSquared == BIG_NUMBER)
+		return MaxNetworkSmoothingMode;
+
+	const float DistanceSquared = MinDistanceSquared / FMath::Square(FMath::Max(SmoothingSignificance, KINDA_SMALL_NUMBER));
+	if (DistanceSquared > FMath::Square(SmoothingLODDisabledDistance))
+		return ENetworkSmoothingMode::Disabled;
+
+	if (DistanceSquared > FMath::Square(SmoothingLODLinearDistance) && MaxNetworkSmoothingMode == ENetworkSmoothingMode::Exponential)
+		return ENetworkSmoothingMode::Linear;
+
+	return MaxNetworkSmoothingMode;
+}
+
+bool UExtCharacterMovementComponent::IsProxyAtRest() const
+{
+	return bNetworkSmoothingComplete
+		&& IsMovingOnGround()
+		&& CurrentFloor.IsWalkableFloor()
+		&& Velocity.IsZero()
+		&& SimulatedAcceleration.IsZero()
+		&& PendingLaunchVelocity.IsZero()
+		&& PendingForceToApply.IsZero()
+		&& PendingImpulseToApply.IsZero()
+		&& !bForceNextFloorCheck
+		&& !HasAnimRootMotion()
+		&& !CurrentRootMotion.HasActiveRootMotionSources()
+		&& !MovementBaseUtility::IsDynamicBase(CharacterOwner->GetMovementBase());
+}
+
+void UExtCharacterMovementComponent::ServerMove_HandleMoveData(const FCharacterNetworkMoveDataContainer& MoveDataContainer)
+{
+	UServerMoveQueueSubsystem* MoveQueueSubsystem = bQueueServerMoves ? GetWorld()->GetSubsystem<UServerMoveQueueSubsystem>() : nullptr;
+	if (!MoveQueueSubsystem || !HasValidData())
+	{
+		Super::ServerMove_HandleMoveData(MoveDataContainer);
+		return;
+	}
+
+	const bool bWasQueueEmpty = QueuedServerMoves.Num() == 0;
+
+	if (MoveDataContainer.bHasOldMove)
+	{
+		if (const FCharacterNetworkMoveData* OldMove = MoveDataContainer.GetOldMoveData())
+			EnqueueServerMove(*OldMove);
+	}
+
+	if (MoveDataContainer.bIsDualMove)
+	{
+		if (const FCharacterNetworkMoveData* PendingMove = MoveDataContainer.GetPendingMoveData())
+			EnqueueServerMove(*PendingMove);
+	}
+
+	if (const FCharacterNetworkMoveData* NewMove = MoveDataContainer.GetNewMoveData())
+		EnqueueServerMove(*NewMove);
+
+	if (bWasQueueEmpty && QueuedServerMoves.Num() > 0)
+		MoveQueueSubsystem->RegisterMoveQueue(this);
+}
+
+void UExtCharacterMovementComponent::EnqueueServerMove(const FCharacterNetworkMoveData& MoveData)
+{
+	INC_DWORD_STAT(STAT_CharacterMovementServerMovesQueued);
+
+	const UServerMoveQueueSubsystem* MoveQueueSubsystem = GetWorld()->GetSubsystem<UServerMoveQueueSubsystem>();
+	if (MoveQueueSubsystem && QueuedServerMoves.Num() >= MoveQueueSubsystem->MaxQueuedMovesPerCharacter)
+	{
+		INC_DWORD_STAT(STAT_CharacterMovementServerMovesOverQueueLimit);
+		ProcessQueuedServerMove();
+	}
+
+	QueuedServerMoves.Emplace(MoveData);
+}
+
+bool UExtCharacterMovementComponent::CanCombineQueuedServerMoves(const FCharacterNetworkMoveData& Move, const FCharacterNetworkMoveData& NewMove, float PrevTimeStamp) const
+{
+	// Out of order, duplicated or across a time stamp reset
+	if (NewMove.TimeStamp <= Move.TimeStamp || Move.TimeStamp <= PrevTimeStamp)
+		return false;
+
+	// Same input and state for the whole span. Compressed flags include the walk, sprint and generic action flags of FSavedMove_ExtCharacter.
+	if (Move.CompressedMoveFlags != NewMove.CompressedMoveFlags
+		|| Move.Acceleration != NewMove.Acceleration
+		|| Move.ControlRotation != NewMove.ControlRotation
+		|| Move.MovementMode != NewMove.MovementMode
+		|| Move.MovementBase != NewMove.MovementBase
+		|| Move.MovementBaseBoneName != NewMove.MovementBaseBoneName)
+	{
+		return false;
+	}
+
+	// The client never combines across jump or crouch transitions, which the server can't tell apart from held input
+	if (Move.CompressedMoveFlags & (FSavedMove_Character::FLAG_JumpPressed | FSavedMove_Character::FLAG_WantsToCrouch))
+		return false;
+
+	// The client never combines a move starting at rest with one that doesn't. Only a character at rest on the ground without
+	// acceleration is known to start both moves the same way.
+	if (!Move.Acceleration.IsZero() || !Velocity.IsZero() || !IsMovingOnGround())
+		return false;
+
+	// Root motion depends on the delta time of each move
+	if (CharacterOwner->IsPlayingNetworkedRootMotionMontage() || CurrentRootMotion.HasActiveRootMotionSources())
+		return false;
+
+	// The combined move must not be clamped by the server
+	const FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
+	return NewMove.TimeStamp - PrevTimeStamp <= ServerData->MaxMoveDeltaTime * CharacterOwner->GetActorTimeDilation();
+}
+
+bool UExtCharacterMovementComponent::ProcessQueuedServerMove()
+{
+	if (QueuedServerMoves.Num() == 0)
+		return false;
+
+	FExtQueuedServerMove QueuedMove = QueuedServerMoves[0];
+	QueuedServerMoves.RemoveAt(0, 1, false);
+
+	if (!HasValidData())
+		return true;
+
+	// Combined here rather than when queued since the start velocity of the move is only known now
+	if (bCombineQueuedServerMoves)
+	{
+		const float PrevTimeStamp = GetPredictionData_Server_Character()->CurrentClientTimeStamp;
+		while (QueuedServerMoves.Num() > 0 && CanCombineQueuedServerMoves(QueuedMove.MoveData, QueuedServerMoves[0].MoveData, PrevTimeStamp))
+		{
+			// Delta time is derived from the previous time stamp so the remaining move covers both
+			QueuedMove = QueuedServerMoves[0];
+			QueuedServerMoves.RemoveAt(0, 1, false);
+			INC_DWORD_STAT(STAT_CharacterMovementServerMovesCombined);
+		}
+	}
+
+	QueuedMove.MoveData.MovementBase = QueuedMove.MovementBase.Get();
+	SetCurrentNetworkMoveData(&QueuedMove.MoveData);
+	ServerMove_PerformMovement(QueuedMove.MoveData);
+	SetCurrentNetworkMoveData(nullptr);
+	return true;
+}
+
+void UExtCharacterMovementComponent::ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse)
+{
+	// The response is always ExtMoveResponseDataContainer, set in the constructor
+	CorrectionResponse = static_cast<const FExtCharacterMoveResponseDataContainer*>(&MoveResponse);
+	Super::ClientHandleMoveResponse(MoveResponse);
+	CorrectionResponse = nullptr;
+}
+
+void UExtCharacterMovementComponent::OnClientCorrectionReceived(FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode)
+{
+	Super::OnClientCorrectionReceived(ClientData, TimeStamp, NewLocation, NewVelocity, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode);
+
+	if (bRecordCorrectionDiagnostics)
+		RecordClientCorrection(ClientData, NewLocation);
+}
+
+void UExtCharacterMovementComponent::RecordClientCorrection(const FNetworkPredictionData_Client_Character& ClientData, const FVector& NewLocation)
+{
+	// The corrected move has just been acked, every saved move left is replayed on top of the correction
+	const FSavedMove_ExtCharacter* AckedMove = static_cast<const FSavedMove_ExtCharacter*>(ClientData.LastAckedMove.Get());
+	const float PositionError = AckedMove ? FVector::Dist(AckedMove->SavedLocation, NewLocation) : 0.0f;
+	const int32 NumMovesReplayed = ClientData.SavedMoves.Num();
+
+	FExtCorrectionDiagnostics& Diagnostics = GetCorrectionDiagnostics();
+	Diagnostics.PositionErrorHistogram.AddMeasurement(PositionError);
+	Diagnostics.MovesReplayedHistogram.AddMeasurement(NumMovesReplayed);
+	Diagnostics.NumCorrections += 1;
+	Diagnostics.NumMovesReplayed += NumMovesReplayed;
+	Diagnostics.CorrectionsInWindow += 1;
+	Diagnostics.MovesReplayedInWindow += NumMovesReplayed;
+
+	bool bGaitDiffered = false;
+	bool bTurnInPlaceDiffered = false;
+	bool bPivotTurnDiffered = false;
+	bool bRotationModeDiffered = false;
+
+	if (AckedMove && CorrectionResponse && CorrectionResponse->bHasExtState)
+	{
+		const float ClientTargetYaw = AckedMove->SavedTurnInPlaceTargetYaw;
+		const float ServerTargetYaw = CorrectionResponse->TurnInPlaceTargetYaw;
+
+		bGaitDiffered = AckedMove->SavedGait != CorrectionResponse->Gait;
+		bPivotTurnDiffered = AckedMove->bSavedIsPivotTurning != CorrectionResponse->bIsPivotTurning;
+		bRotationModeDiffered = AckedMove->SavedRotationMode != CorrectionResponse->RotationMode;
+		// Non finite values encode done and suspended
+		bTurnInPlaceDiffered = (FMath::IsFinite(ClientTargetYaw) && FMath::IsFinite(ServerTargetYaw))
+			? FMath::Abs(FMath::FindDeltaAngleDegrees(ClientTargetYaw, ServerTargetYaw)) > 1.0f
+			: ClientTargetYaw != ServerTargetYaw;
+
+		Diagnostics.NumGaitDiffered += bGaitDiffered ? 1 : 0;
+		Diagnostics.NumTurnInPlaceDiffered += bTurnInPlaceDiffered ? 1 : 0;
+		Diagnostics.NumPivotTurnDiffered += bPivotTurnDiffered ? 1 : 0;
+		Diagnostics.NumRotationModeDiffered += bRotationModeDiffered ? 1 : 0;
+	}
+	else
+	{
+		Diagnostics.NumWithoutExtState += 1;
+	}
+
+	UE_LOG(LogExtCharacterMovement, Verbose, TEXT("Correction of %s: error %.2f, replaying %d moves, differed gait %d turn in place %d pivot turn %d rotation mode %d"),
+		*GetNameSafe(CharacterOwner), PositionError, NumMovesReplayed, bGaitDiffered, bTurnInPlaceDiffered, bPivotTurnDiffered, bRotationModeDiffered);
+
+	INC_DWORD_STAT(STAT_CharacterMovementClientCorrections);
+	INC_DWORD_STAT_BY(STAT_CharacterMovementClientCorrectionMovesReplayed, NumMovesReplayed);
+	INC_DWORD_STAT_BY(STAT_CharacterMovementClientCorrectionsGaitDiffered, bGaitDiffered ? 1 : 0);
+	INC_DWORD_STAT_BY(STAT_CharacterMovementClientCorrectionsTurnInPlaceDiffered, bTurnInPlaceDiffered ? 1 : 0);
+	INC_DWORD_STAT_BY(STAT_CharacterMovementClientCorrectionsPivotTurnDiffered, bPivotTurnDiffered ? 1 : 0);
+	INC_DWORD_STAT_BY(STAT_CharacterMovementClientCorrectionsRotationModeDiffered, bRotationModeDiffered ? 1 : 0);
+	SET_FLOAT_STAT(STAT_CharacterMovementClientCorrectionError, PositionError);
+
+	CSV_CUSTOM_STAT(ExtCharacterCorrections, Corrections, 1, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(ExtCharacterCorrections, MovesReplayed, NumMovesReplayed, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(ExtCharacterCorrections, MaxPositionError, PositionError, ECsvCustomStatOp::Max);
+	CSV_CUSTOM_STAT(ExtCharacterCorrections, GaitDiffered, bGaitDiffered ? 1 : 0, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(ExtCharacterCorrections, TurnInPlaceDiffered, bTurnInPlaceDiffered ? 1 : 0, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(ExtCharacterCorrections, PivotTurnDiffered, bPivotTurnDiffered ? 1 : 0, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(ExtCharacterCorrections, RotationModeDiffered, bRotationModeDiffered ? 1 : 0, ECsvCustomStatOp::Accumulate);
+}
+
+void UExtCharacterMovementComponent::DumpCorrectionDiagnostics()
+{
+	FExtCorrectionDiagnostics& Diagnostics = GetCorrectionDiagnostics();
+
+	UE_LOG(LogExtCharacterMovement, Log, TEXT("Client corrections: %d, moves replayed: %d, without server ext state: %d"),
+		Diagnostics.NumCorrections, Diagnostics.NumMovesReplayed, Diagnostics.NumWithoutExtState);
+	UE_LOG(LogExtCharacterMovement, Log, TEXT("Ext state differed: gait %d, turn in place %d, pivot turn %d, rotation mode %d"),
+		Diagnostics.NumGaitDiffered, Diagnostics.NumTurnInPlaceDiffered, Diagnostics.NumPivotTurnDiffered, Diagnostics.NumRotationModeDiffered);
+
+	Diagnostics.PositionErrorHistogram.DumpToLog(TEXT("Client correction position error"));
+	Diagnostics.MovesReplayedHistogram.DumpToLog(TEXT("Client correction moves replayed"));
+}
+
+void UExtCharacterMovementComponent::ResetCorrectionDiagnostics()
+{
+	GetCorrectionDiagnostics().Reset();
+}
+
+void UExtCharacterMovementComponent::GetCorrectionDiagnosticsTotals(int32& OutNumCorrections, int32& OutNumMovesReplayed)
+{
+	const FExtCorrectionDiagnostics& Diagnostics = GetCorrectionDiagnostics();
+	OutNumCorrections = Diagnostics.NumCorrections;
+	OutNumMovesReplayed = Diagnostics.NumMovesReplayed;
+}
+
+uint64 UExtCharacterMovementComponent::GetProxySimulationCycles()
+{
+	return GProxySimulationCycles;
 }
 
 
@@ -702,8 +1183,15 @@ void UExtCharacterMovementComponent::SimulateMovement(float DeltaSeconds)
 		OldVelocity = Velocity;
 		OldLocation = UpdatedComponent->GetComponentLocation();
 
+		// Nothing to predict while standing still where the server last put us
+		const bool bIsAtRest = bIsSimulatedProxy && !bHandledNetUpdate && bSkipSimulationAtRest && IsProxyAtRest();
+		if (bIsAtRest)
+		{
+			INC_DWORD_STAT(STAT_CharacterMovementProxiesAtRest);
+		}
+
 		// May only need to simulate forward on frames where we haven't just received a new position update.
-		if (!bHandledNetUpdate || !bNetworkSkipProxyPredictionOnNetUpdate || !GetCVarNetEnableSkipProxyPredictionOnNetUpdate())
+		if (!bIsAtRest && (!bHandledNetUpdate || !bNetworkSkipProxyPredictionOnNetUpdate || !GetCVarNetEnableSkipProxyPredictionOnNetUpdate()))
 		{
 			UE_LOG(LogExtCharacterMovement, Verbose, TEXT("Proxy %s simulating movement"), *GetNameSafe(CharacterOwner));
 			FStepDownResult StepDownResult;
@@ -1657,8 +2145,6 @@ bool UExtCharacterMovementComponent::GetOverrideAndAdditiveRootMotionRotation(fl
 
 bool UExtCharacterMovementComponent::CanTurnInPlaceInCurrentState() const
 {
-	checkComponentRoleAtLeast(ROLE_AutonomousProxy);
-
 	// No need to test for ragdoll here since by definition the capsule does not rotate for ragdolls.
 	// The root bone is adjusted instead.
 	return bEnableTurnInPlace
@@ -1667,6 +2153,22 @@ bool UExtCharacterMovementComponent::CanTurnInPlaceInCurrentState() const
 		&& !HasRootMotionSources();
 }
 
+bool UExtCharacterMovementComponent::CanUpdateTurnInPlace(bool bHasDesiredRotation, bool& bOutKeepTarget) const
+{
+	check(ExtCharacterOwner);
+
+	bOutKeepTarget = ExtCharacterOwner->IsRagdoll() || ExtCharacterOwner->IsGettingUp();
+	if (bOutKeepTarget)
+		return false;
+
+	return !bOrientRotationToMovement
+		&& bHasDesiredRotation
+		&& bUseControllerDesiredRotation
+		&& !(MovementMode == MOVE_Falling && !(bCanRotateWhileJumping && ExtCharacterOwner->bIsJumping))
+		&& Velocity.SizeSquared2D() < KINDA_SMALL_NUMBER
+		&& CanTurnInPlaceInCurrentState();
+}
+
 void UExtCharacterMovementComponent::ResetTurnInPlaceState()
 {
 	// Reset TurnInPlace control variables.
@@ -1674,10 +2176,99 @@ void UExtCharacterMovementComponent::ResetTurnInPlaceState()
 	// conditionally assign to avoid stalls despite how good the CPU jump prediction could be.
 	check(ExtCharacterOwner)
 	bCanEnforceTurnInPlaceRotationMaxDistance = false;
+	bTurnInPlaceStepAmbiguous = false;
 	TurnInPlaceTargetYaw = -INFINITY;
 	TurnInPlaceTimeCounter = 0.0f;
 }
 
+bool UExtCharacterMovementComponent::GetTurnInPlaceAngle(float LookYawDelta, float& OutTurnInPlaceAngle) const
+{
+	const float MaxLookYawAngle = FMath::Clamp(LookAngleThreshold, 45.f, 90.f);
+	const float LookYawAngle = FMath::Abs(LookYawDelta);
+	if (LookYawAngle <= MaxLookYawAngle)
+		return false;
+
+	const bool bIsLookingRight = LookYawDelta >= 0.0f;
+	const int32 TurnInPlaceSteps = ((FMath::FloorToInt(LookYawAngle - MaxLookYawAngle) / 90) + 1);
+	OutTurnInPlaceAngle = TurnInPlaceSteps * (bIsLookingRight ? 90.0f : -90.f);
+	return true;
+}
+
+bool UExtCharacterMovementComponent::IsTurnInPlaceStepAmbiguous(float LookYawDelta) const
+{
+	// Close to the look angle threshold itself proxies could disagree on whether a turn starts at all, and close to the following
+	// boundaries on the number of steps
+	const float Excess = FMath::Abs(LookYawDelta) - FMath::Clamp(LookAngleThreshold, 45.f, 90.f);
+	if (Excess <= -ProxyTurnInPlaceStepMargin)
+		return false;
+
+	const float Remainder = FMath::Fmod(FMath::Max(Excess, 0.0f), 90.0f);
+	return Remainder < ProxyTurnInPlaceStepMargin || Remainder > 90.0f - ProxyTurnInPlaceStepMargin;
+}
+
+void UExtCharacterMovementComponent::PredictProxyTurnInPlace(float DeltaSeconds)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CharacterMovementPredictProxyTurnInPlace);
+
+	// Proxies see rotation quantized to bytes, so completion uses a tolerance of about one quantization step
+	static const float ProxyTurnInPlaceTolerance = 1.5f;
+
+	// The replicated look rotation takes the place of the controller
+	bool bKeepTurnInPlaceTarget;
+	if (!CanUpdateTurnInPlace(true, bKeepTurnInPlaceTarget))
+	{
+		if (!bKeepTurnInPlaceTarget)
+		{
+			TurnInPlaceTargetYaw = -INFINITY;
+			TurnInPlaceTimeCounter = 0.0f;
+		}
+
+		return;
+	}
+
+	// Restore TurnInPlace from suspension.
+	if (!FMath::IsFinite(TurnInPlaceTargetYaw) && TurnInPlaceTargetYaw < 0.f)
+		TurnInPlaceTargetYaw = INFINITY;
+
+	const float CurrentYaw = UpdatedComponent->GetComponentRotation().Yaw;
+	const float LookYaw = ExtCharacterOwner->GetLookRotation().Yaw;
+
+	if (FMath::IsFinite(TurnInPlaceTargetYaw) && FMath::Abs(FMath::FindDeltaAngleDegrees(CurrentYaw, TurnInPlaceTargetYaw)) <= ProxyTurnInPlaceTolerance)
+	{
+		TurnInPlaceTargetYaw = INFINITY;
+		return;
+	}
+
+	float TurnInPlaceAngle;
+	if (bUseTurnInPlaceDelay && TurnInPlaceDelay > 0.01f)
+	{
+		if (!FMath::IsFinite(TurnInPlaceTargetYaw))
+		{
+			if (GetTurnInPlaceAngle(FMath::FindDeltaAngleDegrees(CurrentYaw, LookYaw), TurnInPlaceAngle))
+			{
+				TurnInPlaceTimeCounter += DeltaSeconds;
+				if (TurnInPlaceTimeCounter > TurnInPlaceDelay)
+				{
+					TurnInPlaceTargetYaw = CurrentYaw + TurnInPlaceAngle;
+					TurnInPlaceTimeCounter = 0.0f;
+				}
+			}
+			else
+			{
+				TurnInPlaceTimeCounter = 0.0f;
+			}
+		}
+	}
+	else
+	{
+		TurnInPlaceTimeCounter = 0.0f;
+
+		const float CurrentTargetYaw = FMath::IsFinite(TurnInPlaceTargetYaw) ? TurnInPlaceTargetYaw : CurrentYaw;
+		if (GetTurnInPlaceAngle(FMath::FindDeltaAngleDegrees(CurrentTargetYaw, LookYaw), TurnInPlaceAngle))
+			TurnInPlaceTargetYaw = FMath::UnwindDegrees(CurrentTargetYaw + TurnInPlaceAngle);
+	}
+}
+
 void UExtCharacterMovementComponent::ResetControllerDesireRotationState()
 {
 	// Reset Controller Desired Rotation control variables
@@ -1701,7 +2292,9 @@ void UExtCharacterMovementComponent::PhysicsRotation(float DeltaSeconds)
 	FRotator CurrentRotation = UpdatedComponent->GetComponentRotation(); // Normalized
 	CurrentRotation.DiagnosticCheckNaN(TEXT("CharacterMovementComponent::PhysicsRotation(): CurrentRotation"));
 
-	if (ExtCharacterOwner->IsRagdoll() || ExtCharacterOwner->IsGettingUp())
+	bool bKeepTurnInPlaceTarget;
+	const bool bCanUpdateTurnInPlace = CanUpdateTurnInPlace(CharacterOwner->Controller != nullptr, bKeepTurnInPlaceTarget);
+	if (bKeepTurnInPlaceTarget)
 		return;
 
 	FRotator DeltaRot(EForceInit::ForceInitToZero);
@@ -1758,7 +2351,7 @@ void UExtCharacterMovementComponent::PhysicsRotation(float DeltaSeconds)
 			{
 				ResetControllerDesireRotationState();
 
-				if (CanTurnInPlaceInCurrentState())
+				if (bCanUpdateTurnInPlace)
 				{
 					// Restore TurnInPlace from suspension.
 					if (!FMath::IsFinite(TurnInPlaceTargetYaw) && TurnInPlaceTargetYaw < 0.f)
@@ -1770,19 +2363,17 @@ void UExtCharacterMovementComponent::PhysicsRotation(float DeltaSeconds)
 					{
 						if (!FMath::IsFinite(TurnInPlaceTargetYaw)) // if not turning in place
 						{
-							const float MaxLookYawAngle = FMath::Clamp(LookAngleThreshold, 45.f, 90.f);
 							const float LookYawDelta = FMath::FindDeltaAngleDegrees(CurrentRotation.Yaw, ControlRotation.Yaw);
-							const float LookYawAngle = FMath::Abs(LookYawDelta);
 
-							if (LookYawAngle > MaxLookYawAngle)
+							// Also tracked while idle since proxies could disagree on whether a turn starts at all
+							bTurnInPlaceStepAmbiguous = IsTurnInPlaceStepAmbiguous(LookYawDelta);
+
+							float TurnInPlaceAngle;
+							if (GetTurnInPlaceAngle(LookYawDelta, TurnInPlaceAngle))
 							{
 								TurnInPlaceTimeCounter += DeltaSeconds;
 								if (TurnInPlaceTimeCounter > TurnInPlaceDelay)
 								{
-									const bool bIsLookingRight = LookYawDelta >= 0.0f;
-									const int32 TurnInPlaceSteps = ((FMath::FloorToInt(LookYawAngle - MaxLookYawAngle) / 90) + 1);
-									const float TurnInPlaceAngle = TurnInPlaceSteps * (bIsLookingRight ? 90.0f : -90.f);
-
 									TurnInPlaceTargetYaw = CurrentRotation.Yaw + TurnInPlaceAngle;
 									TurnInPlaceTimeCounter = 0.0f;
 								}
@@ -1822,20 +2413,23 @@ void UExtCharacterMovementComponent::PhysicsRotation(float DeltaSeconds)
 						const float CurrentTargetYaw = FMath::IsFinite(TurnInPlaceTargetYaw) ? TurnInPlaceTargetYaw : CurrentRotation.Yaw;
 						const float LookYawDelta = FMath::FindDeltaAngleDegrees(CurrentTargetYaw, ControlRotation.Yaw);
 
-						const float MaxLookYawAngle = FMath::Clamp(LookAngleThreshold, 45.f, 90.f);
-						const float LookYawAngle = FMath::Abs(LookYawDelta);
+						// A turn that started ambiguous stays so until it is done. Idle characters are tracked too since proxies could
+						// disagree on whether a turn starts at all.
+						const bool bIsTurningInPlace = FMath::IsFinite(TurnInPlaceTargetYaw);
 
-						if (LookYawAngle > MaxLookYawAngle)
+						float TurnInPlaceAngle;
+						if (GetTurnInPlaceAngle(LookYawDelta, TurnInPlaceAngle))
 						{
-							const bool bIsLookingRight = LookYawDelta >= 0.0f;
-							const int32 TurnInPlaceSteps = ((FMath::FloorToInt(LookYawAngle - MaxLookYawAngle) / 90) + 1);
-							const float TurnInPlaceAngle = TurnInPlaceSteps * (bIsLookingRight ? 90.0f : -90.f);
-
 							TurnInPlaceTargetYaw = FMath::UnwindDegrees(CurrentTargetYaw + TurnInPlaceAngle);
+							bTurnInPlaceStepAmbiguous = IsTurnInPlaceStepAmbiguous(LookYawDelta);
+						}
+						else
+						{
+							bTurnInPlaceStepAmbiguous = (bIsTurningInPlace && bTurnInPlaceStepAmbiguous) || IsTurnInPlaceStepAmbiguous(LookYawDelta);
 						}
 					}
 				}
-				else // if (!CanTurnInPlaceInCurrentState())
+				else // if (!bCanUpdateTurnInPlace)
 				{
 					ResetTurnInPlaceState();
 					return;
@@ -2345,6 +2939,11 @@ void FSavedMove_ExtCharacter::Clear()
 	bWantsToWalkInsteadOfRun = false;
 	bWantsToSprint = false;
 	bWantsToPerformGenericAction = false;
+
+	bSavedIsPivotTurning = false;
+	SavedGait = ECharacterGait::Run;
+	SavedRotationMode = ECharacterRotationMode::None;
+	SavedTurnInPlaceTargetYaw = INFINITY;
 }
 
 void FSavedMove_ExtCharacter::SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
@@ -2367,6 +2966,19 @@ void FSavedMove_ExtCharacter::PrepMoveFor(ACharacter* Character)
 	// Don't update flags here. They're automatically setup before corrections using the compressed flag methods.
 }
 
+void FSavedMove_ExtCharacter::PostUpdate(ACharacter* Character, EPostUpdateMode PostUpdateMode)
+{
+	Super::PostUpdate(Character, PostUpdateMode);
+
+	const AExtCharacter* const ExtCharacter = CastChecked<AExtCharacter>(Character);
+	const UExtCharacterMovementComponent* const ExtCharacterMovement = CastChecked<UExtCharacterMovementComponent>(Character->GetCharacterMovement());
+
+	bSavedIsPivotTurning = ExtCharacterMovement->IsPivotTurning();
+	SavedGait = ExtCharacter->GetGait();
+	SavedRotationMode = ExtCharacter->GetRotationMode();
+	SavedTurnInPlaceTargetYaw = ExtCharacterMovement->GetTurnInPlaceTargetYaw();
+}
+
 uint8 FSavedMove_ExtCharacter::GetCompressedFlags() const
 {
 	uint8 Result = Super::GetCompressedFlags();
@@ -2383,6 +2995,62 @@ uint8 FSavedMove_ExtCharacter::GetCompressedFlags() const
 	return Result;
 }
 
+FExtCharacterMoveResponseDataContainer::FExtCharacterMoveResponseDataContainer()
+	: bHasExtState(false)
+	, bIsPivotTurning(false)
+	, Gait(ECharacterGait::Run)
+	, RotationMode(ECharacterRotationMode::None)
+	, TurnInPlaceTargetYaw(INFINITY)
+{
+}
+
+void FExtCharacterMoveResponseDataContainer::ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment)
+{
+	Super::ServerFillResponseData(CharacterMovement, PendingAdjustment);
+
+	const UExtCharacterMovementComponent& ExtCharacterMovement = static_cast<const UExtCharacterMovementComponent&>(CharacterMovement);
+	const AExtCharacter* ExtCharacter = Cast<AExtCharacter>(CharacterMovement.GetCharacterOwner());
+
+	// Only corrections carry the ext state, good moves stay as small as before
+	bHasExtState = !IsGoodMove() && ExtCharacterMovement.bRecordCorrectionDiagnostics && ExtCharacter;
+	if (bHasExtState)
+	{
+		bIsPivotTurning = ExtCharacterMovement.IsPivotTurning();
+		Gait = ExtCharacter->GetGait();
+		RotationMode = ExtCharacter->GetRotationMode();
+		TurnInPlaceTargetYaw = ExtCharacterMovement.GetTurnInPlaceTargetYaw();
+	}
+}
+
+bool FExtCharacterMoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap)
+{
+	if (!Super::Serialize(CharacterMovement, Ar, PackageMap))
+		return false;
+
+	if (IsGoodMove())
+	{
+		bHasExtState = false;
+		return !Ar.IsError();
+	}
+
+	Ar.SerializeBits(&bHasExtState, 1);
+	if (bHasExtState)
+	{
+		uint8 GaitValue = (uint8)Gait;
+		uint8 RotationModeValue = (uint8)RotationMode;
+
+		Ar.SerializeBits(&bIsPivotTurning, 1);
+		Ar << GaitValue;
+		Ar << RotationModeValue;
+		Ar << TurnInPlaceTargetYaw;
+
+		Gait = (ECharacterGait)GaitValue;
+		RotationMode = (ECharacterRotationMode)RotationModeValue;
+	}
+
+	return !Ar.IsError();
+}
+
 FNetworkPredictionData_Client_ExtCharacter::FNetworkPredictionData_Client_ExtCharacter(const UCharacterMovementComponent& ClientMovement)
 	: Super(ClientMovement)
 {
@@ -0,0 +1,100 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "GameFramework/HitReactComponent.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/ExtCharacter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Char HitReact"), STAT_HitReact, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Reacts Played"), STAT_HitReactsPlayed, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Reacts Rewound"), STAT_HitReactsRewound, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Reacts Coalesced"), STAT_HitReactsCoalesced, STATGROUP_Character);
+
+UHitReactComponent::UHitReactComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	DefaultMontage = nullptr;
+	PlayRate = 1.f;
+	CoalesceWindow = 0.15f;
+	LastReactTime = -BIG_NUMBER;
+	NumCoalescedHits = 0;
+
+	for (int32 Index = 0; Index < NumDirections; ++Index)
+		MontageTable[Index] = nullptr;
+}
+
+void UHitReactComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	RebuildMontageTable();
+
+	if (AExtCharacter* Character = Cast<AExtCharacter>(GetOwner()))
+		Character->HitReactNativeDelegate.AddUObject(this, &UHitReactComponent::HandleHitReact);
+}
+
+void UHitReactComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (AExtCharacter* Character = Cast<AExtCharacter>(GetOwner()))
+		Character->HitReactNativeDelegate.RemoveAll(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UHitReactComponent::RebuildMontageTable()
+{
+	for (int32 Index = 0; Index < NumDirections; ++Index)
+	{
+		UAnimMontage* const* Montage = Montages.Find((ECardinalDirection)Index);
+		MontageTable[Index] = Montage && *Montage ? *Montage : DefaultMontage;
+	}
+}
+
+void UHitReactComponent::HandleHitReact(AExtCharacter* Sender, ECardinalDirection HitDirection, AActor* DamageCauser)
+{
+	PlayHitReact(HitDirection);
+}
+
+void UHitReactComponent::PlayHitReact(ECardinalDirection HitDirection)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HitReact);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	if (Now - LastReactTime < CoalesceWindow)
+	{
+		INC_DWORD_STAT(STAT_HitReactsCoalesced);
+		++NumCoalescedHits;
+		return;
+	}
+
+	const int32 Index = (int32)HitDirection;
+	UAnimMontage* Montage = Index >= 0 && Index < NumDirections ? MontageTable[Index] : DefaultMontage;
+	UAnimInstance* AnimInstance = GetAnimInstance();
+	if (!Montage || !AnimInstance)
+		return;
+
+	LastReactTime = Now;
+
+	// Rewind the reaction if it is still playing instead of allocating a new montage instance and blending between the two
+	if (FAnimMontageInstance* MontageInstance = AnimInstance->GetActiveInstanceForMontage(Montage))
+	{
+		MontageInstance->SetPosition(0.f);
+		MontageInstance->SetPlayRate(PlayRate);
+		MontageInstance->Play(PlayRate);
+		INC_DWORD_STAT(STAT_HitReactsRewound);
+		return;
+	}
+
+	AnimInstance->Montage_Play(Montage, PlayRate);
+	INC_DWORD_STAT(STAT_HitReactsPlayed);
+}
+
+UAnimInstance* UHitReactComponent::GetAnimInstance() const
+{
+	const ACharacter* Character = Cast<ACharacter>(GetOwner());
+	const USkeletalMeshComponent* Mesh = Character ? Character->GetMesh() : nullptr;
+	return Mesh ? Mesh->GetAnimInstance() : nullptr;
+}
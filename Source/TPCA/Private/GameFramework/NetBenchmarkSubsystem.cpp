@@ -0,0 +1,285 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "GameFramework/NetBenchmarkSubsystem.h"
+#include "GameFramework/ExtCharacter.h"
+#include "GameFramework/ExtCharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Engine/Engine.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogNetBenchmark, Log, All);
+
+UNetBenchmarkSubsystem::UNetBenchmarkSubsystem()
+{
+	WarmupTime = 10.0f;
+	Duration = 60.0f;
+	StartTime = -1.0f;
+	bIsFinished = false;
+	NumFrames = 0;
+	CpuSeconds = 0.0;
+	NextBandwidthSampleTime = 0.0f;
+	NumBandwidthSamples = 0;
+	InBytesPerSecond = 0.0;
+	OutBytesPerSecond = 0.0;
+	NumConnectionSamples = 0.0;
+	StartProxySimulationCycles = 0;
+	StartNumCorrections = 0;
+	StartNumMovesReplayed = 0;
+	NumProxyFrames = 0;
+	CirclePhase = 0.0f;
+	NextActionTime = 0.0f;
+	StopJumpingTime = -1.0f;
+	ResumeMovingTime = 0.0f;
+}
+
+bool UNetBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer))
+		return false;
+
+	const EWorldType::Type WorldType = CastChecked<UWorld>(Outer)->WorldType;
+	return WorldType == EWorldType::Game && FParse::Param(FCommandLine::Get(), TEXT("NetBenchmark"));
+}
+
+void UNetBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	int32 ClientIndex = 0;
+	FParse::Value(CommandLine, TEXT("BenchmarkWarmup="), WarmupTime);
+	FParse::Value(CommandLine, TEXT("BenchmarkDuration="), Duration);
+	FParse::Value(CommandLine, TEXT("BenchmarkReport="), ReportPath);
+	FParse::Value(CommandLine, TEXT("BenchmarkClient="), ClientIndex);
+
+	// Each client moves differently but the same way on every run
+	RandomStream.Initialize(ClientIndex + 1);
+	CirclePhase = RandomStream.FRandRange(0.0f, 2.0f * PI);
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UNetBenchmarkSubsystem::HandlePreActorTick);
+}
+
+void UNetBenchmarkSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+	if (ActorSpawnedHandle.IsValid())
+		GetWorld()->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+
+	Super::Deinitialize();
+}
+
+void UNetBenchmarkSubsystem::HandlePreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	UWorld* World = GetWorld();
+	if (InWorld != World || bIsFinished)
+		return;
+
+	const float Now = World->GetTimeSeconds();
+
+	// Clients wait for their character, the warmup gives every client time to join. Only local controllers are driven, servers must not
+	// move the characters of remote clients themselves.
+	APlayerController* PlayerController = GEngine->GetFirstLocalPlayerController(World);
+	AExtCharacter* Character = PlayerController ? Cast<AExtCharacter>(PlayerController->GetPawn()) : nullptr;
+	if (Character)
+		DriveCharacter(Character, PlayerController, Now);
+
+	const bool bIsServer = World->GetNetMode() < NM_Client;
+	if (StartTime < 0.0f)
+	{
+		if ((bIsServer || Character) && Now >= WarmupTime)
+		{
+			StartTime = Now;
+			StartSampling();
+		}
+		return;
+	}
+
+	SampleFrame();
+
+	if (Now >= NextBandwidthSampleTime)
+	{
+		NextBandwidthSampleTime = Now + 1.0f;
+		SampleBandwidth();
+	}
+
+	if (Now - StartTime >= Duration)
+		Finish();
+}
+
+void UNetBenchmarkSubsystem::StartSampling()
+{
+	UE_LOG(LogNetBenchmark, Display, TEXT("NetBenchmark: sampling for %.0f seconds"), Duration);
+
+	// Servers send their ext state with corrections and clients record them
+	for (TActorIterator<AExtCharacter> It(GetWorld()); It; ++It)
+		RecordCorrectionDiagnostics(*It);
+
+	// Characters that spawn later, e.g. when they become relevant to a client, are sampled too
+	ActorSpawnedHandle = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UNetBenchmarkSubsystem::HandleActorSpawned));
+
+	StartProxySimulationCycles = UExtCharacterMovementComponent::GetProxySimulationCycles();
+	UExtCharacterMovementComponent::GetCorrectionDiagnosticsTotals(StartNumCorrections, StartNumMovesReplayed);
+	NextBandwidthSampleTime = GetWorld()->GetTimeSeconds() + 1.0f;
+}
+
+void UNetBenchmarkSubsystem::HandleActorSpawned(AActor* Actor)
+{
+	if (AExtCharacter* Character = Cast<AExtCharacter>(Actor))
+		RecordCorrectionDiagnostics(Character);
+}
+
+void UNetBenchmarkSubsystem::RecordCorrectionDiagnostics(AExtCharacter* Character)
+{
+	if (UExtCharacterMovementComponent* ExtCharacterMovement = Character->GetExtCharacterMovement())
+		ExtCharacterMovement->bRecordCorrectionDiagnostics = true;
+}
+
+void UNetBenchmarkSubsystem::SampleFrame()
+{
+	// Time spent sleeping to honor the max tick rate is not CPU time
+	CpuSeconds += FMath::Max(FApp::GetDeltaTime() - FApp::GetIdleTime(), 0.0);
+	++NumFrames;
+
+	if (GetWorld()->GetNetMode() == NM_Client)
+	{
+		for (TActorIterator<AExtCharacter> It(GetWorld()); It; ++It)
+		{
+			if (It->GetLocalRole() == ROLE_SimulatedProxy)
+				++NumProxyFrames;
+		}
+	}
+}
+
+void UNetBenchmarkSubsystem::SampleBandwidth()
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	if (!NetDriver)
+		return;
+
+	// Connection rates are updated once per second by the connections themselves
+	if (NetDriver->ServerConnection)
+	{
+		InBytesPerSecond += NetDriver->ServerConnection->InBytesPerSecond;
+		OutBytesPerSecond += NetDriver->ServerConnection->OutBytesPerSecond;
+		NumConnectionSamples += 1.0;
+	}
+	else
+	{
+		for (const UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			InBytesPerSecond += Connection->InBytesPerSecond;
+			OutBytesPerSecond += Connection->OutBytesPerSecond;
+		}
+		NumConnectionSamples += NetDriver->ClientConnections.Num();
+	}
+
+	++NumBandwidthSamples;
+}
+
+void UNetBenchmarkSubsystem::DriveCharacter(AExtCharacter* Character, APlayerController* PlayerController, float Time)
+{
+	// Run in a circle while sweeping the view, with random gait, crouch, jump and stop events so every part of ext movement replicates
+	const float Angle = CirclePhase + Time * 0.5f;
+	if (Time >= ResumeMovingTime)
+		Character->AddMovementInput(FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f), 1.0f);
+
+	PlayerController->SetControlRotation(FRotator(FMath::Sin(Time) * 20.0f, FMath::RadiansToDegrees(Angle) + FMath::Sin(Time * 0.7f) * 60.0f, 0.0f));
+
+	if (StopJumpingTime >= 0.0f && Time >= StopJumpingTime)
+	{
+		Character->StopJumping();
+		StopJumpingTime = -1.0f;
+	}
+
+	if (Time < NextActionTime)
+		return;
+
+	NextActionTime = Time + RandomStream.FRandRange(1.0f, 4.0f);
+
+	const UExtCharacterMovementComponent* ExtCharacterMovement = Character->GetExtCharacterMovement();
+	switch (RandomStream.RandRange(0, 4))
+	{
+		case 0:
+			if (ExtCharacterMovement->bWantsToWalkInsteadOfRun)
+				Character->UnWalk();
+			else
+				Character->Walk();
+			break;
+		case 1:
+			if (ExtCharacterMovement->bWantsToSprint)
+				Character->UnSprint();
+			else
+				Character->Sprint();
+			break;
+		case 2:
+			Character->Jump();
+			StopJumpingTime = Time + 0.2f;
+			break;
+		case 3:
+			if (Character->bIsCrouched)
+				Character->UnCrouch();
+			else
+				Character->Crouch();
+			break;
+		default:
+			ResumeMovingTime = Time + RandomStream.FRandRange(0.5f, 2.0f);
+			break;
+	}
+}
+
+void UNetBenchmarkSubsystem::Finish()
+{
+	bIsFinished = true;
+
+	const UWorld* World = GetWorld();
+	const bool bIsClient = World->GetNetMode() == NM_Client;
+	const double SampledSeconds = World->GetTimeSeconds() - StartTime;
+	const double AvgConnections = NumBandwidthSamples > 0 ? NumConnectionSamples / NumBandwidthSamples : 0.0;
+	const double CpuMsPerFrame = NumFrames > 0 ? CpuSeconds * 1000.0 / NumFrames : 0.0;
+
+	TArray<FString> Lines;
+	Lines.Add(FString::Printf(TEXT("Role,%s"), bIsClient ? TEXT("Client") : TEXT("Server")));
+	Lines.Add(FString::Printf(TEXT("Seconds,%.2f"), SampledSeconds));
+	Lines.Add(FString::Printf(TEXT("Frames,%d"), NumFrames));
+	Lines.Add(FString::Printf(TEXT("CpuMsPerFrame,%.4f"), CpuMsPerFrame));
+	Lines.Add(FString::Printf(TEXT("InBytesPerSecondPerConnection,%.1f"), AvgConnections > 0.0 ? InBytesPerSecond / NumConnectionSamples : 0.0));
+	Lines.Add(FString::Printf(TEXT("OutBytesPerSecondPerConnection,%.1f"), AvgConnections > 0.0 ? OutBytesPerSecond / NumConnectionSamples : 0.0));
+
+	if (bIsClient)
+	{
+		int32 NumCorrections = 0;
+		int32 NumMovesReplayed = 0;
+		UExtCharacterMovementComponent::GetCorrectionDiagnosticsTotals(NumCorrections, NumMovesReplayed);
+		const double ProxyMs = FPlatformTime::ToMilliseconds64(UExtCharacterMovementComponent::GetProxySimulationCycles() - StartProxySimulationCycles);
+
+		Lines.Add(FString::Printf(TEXT("CorrectionsPerSecond,%.3f"), (NumCorrections - StartNumCorrections) / SampledSeconds));
+		Lines.Add(FString::Printf(TEXT("MovesReplayedPerSecond,%.3f"), (NumMovesReplayed - StartNumMovesReplayed) / SampledSeconds));
+		Lines.Add(FString::Printf(TEXT("Proxies,%.1f"), NumFrames > 0 ? (double)NumProxyFrames / NumFrames : 0.0));
+		Lines.Add(FString::Printf(TEXT("ProxyMsPerFrame,%.4f"), NumFrames > 0 ? ProxyMs / NumFrames : 0.0));
+		Lines.Add(FString::Printf(TEXT("ProxyUsPerProxyFrame,%.3f"), NumProxyFrames > 0 ? ProxyMs * 1000.0 / NumProxyFrames : 0.0));
+	}
+	else
+	{
+		Lines.Add(FString::Printf(TEXT("Players,%.1f"), AvgConnections));
+		Lines.Add(FString::Printf(TEXT("CpuMsPerPlayer,%.4f"), AvgConnections > 0.0 ? CpuMsPerFrame / AvgConnections : 0.0));
+	}
+
+	if (ReportPath.IsEmpty())
+		ReportPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("NetBenchmark"), bIsClient ? TEXT("Client.csv") : TEXT("Server.csv"));
+
+	if (FFileHelper::SaveStringArrayToFile(Lines, *ReportPath))
+		UE_LOG(LogNetBenchmark, Display, TEXT("NetBenchmark: report written to %s"), *ReportPath);
+	else
+		UE_LOG(LogNetBenchmark, Error, TEXT("NetBenchmark: could not write report to %s"), *ReportPath);
+
+	FPlatformMisc::RequestExit(false);
+}
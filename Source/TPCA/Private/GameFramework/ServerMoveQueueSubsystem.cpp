@@ -0,0 +1,117 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "GameFramework/ServerMoveQueueSubsystem.h"
+#include "GameFramework/ExtCharacterMovementComponent.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Char Server Move Queue"), STAT_ServerMoveQueue, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Server Moves Processed"), STAT_ServerMovesProcessed, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Server Moves Deferred"), STAT_ServerMovesDeferred, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Server Move Queue Depth"), STAT_ServerMoveQueueDepth, STATGROUP_Character);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Char Server Move Queues"), STAT_ServerMoveQueues, STATGROUP_Character);
+
+UServerMoveQueueSubsystem::UServerMoveQueueSubsystem()
+{
+	MaxProcessingTimeMs = 2.0f;
+	MaxQueuedMovesPerCharacter = 16;
+	NextQueueIndex = 0;
+	NumDeferredMoves = 0;
+}
+
+void UServerMoveQueueSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UServerMoveQueueSubsystem::HandlePreActorTick);
+}
+
+void UServerMoveQueueSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+	MoveQueues.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UServerMoveQueueSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	if (!Super::ShouldCreateSubsystem(Outer))
+		return false;
+
+	const EWorldType::Type WorldType = CastChecked<UWorld>(Outer)->WorldType;
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UServerMoveQueueSubsystem::RegisterMoveQueue(UExtCharacterMovementComponent* MovementComponent)
+{
+	MoveQueues.AddUnique(MovementComponent);
+}
+
+void UServerMoveQueueSubsystem::HandlePreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+	// Moves are received during the net driver tick dispatch so they are all in by now, just like when processed as they arrive
+	if (InWorld == GetWorld())
+		ProcessMoveQueues();
+}
+
+void UServerMoveQueueSubsystem::ProcessMoveQueues()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ServerMoveQueue);
+
+	MoveQueues.RemoveAll([](const TWeakObjectPtr<UExtCharacterMovementComponent>& MoveQueue) { return !MoveQueue.IsValid(); });
+
+	const int32 NumQueues = MoveQueues.Num();
+	NumDeferredMoves = 0;
+	if (NumQueues == 0)
+		return;
+
+	INC_DWORD_STAT_BY(STAT_ServerMoveQueues, NumQueues);
+
+	const int32 FirstQueueIndex = NextQueueIndex % NumQueues;
+	NextQueueIndex = FirstQueueIndex + 1;
+
+	// The first pass always runs so every character makes progress, later passes stop when the budget is spent
+	const double EndTime = FPlatformTime::Seconds() + MaxProcessingTimeMs * 0.001;
+	bool bIsFirstPass = true;
+	bool bAnyProcessed = true;
+	while (bAnyProcessed)
+	{
+		bAnyProcessed = false;
+		for (int32 Offset = 0; Offset < NumQueues; ++Offset)
+		{
+			if (!bIsFirstPass && FPlatformTime::Seconds() > EndTime)
+				break;
+
+			UExtCharacterMovementComponent* MovementComponent = MoveQueues[(FirstQueueIndex + Offset) % NumQueues].Get();
+			if (MovementComponent && MovementComponent->ProcessQueuedServerMove())
+			{
+				INC_DWORD_STAT(STAT_ServerMovesProcessed);
+				bAnyProcessed = true;
+			}
+		}
+
+		if (!bIsFirstPass && FPlatformTime::Seconds() > EndTime)
+			break;
+
+		bIsFirstPass = false;
+	}
+
+	int32 MaxQueueDepth = 0;
+	for (int32 Index = MoveQueues.Num() - 1; Index >= 0; --Index)
+	{
+		const UExtCharacterMovementComponent* MovementComponent = MoveQueues[Index].Get();
+		const int32 NumQueuedMoves = MovementComponent ? MovementComponent->GetNumQueuedServerMoves() : 0;
+		if (NumQueuedMoves == 0)
+		{
+			MoveQueues.RemoveAt(Index, 1, false);
+		}
+		else
+		{
+			NumDeferredMoves += NumQueuedMoves;
+			MaxQueueDepth = FMath::Max(MaxQueueDepth, NumQueuedMoves);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_ServerMovesDeferred, NumDeferredMoves);
+	INC_DWORD_STAT_BY(STAT_ServerMoveQueueDepth, MaxQueueDepth);
+}
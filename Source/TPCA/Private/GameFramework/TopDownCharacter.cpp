@@ -7,11 +7,61 @@
 #include "Components/ArmComponent.h"
 #include "Components/InputComponent.h"
 #include "Components/PushToTargetComponent.h"
+#include "Camera/PlayerCameraManager.h"
 #include "Kismet/Kismet.h"
+#include "SceneView.h"
 #include "DrawDebugHelpers.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogTopDownCharacter, Log, All);
 
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("TopDown Cursor Aim Latency (ms)"), STAT_TopDownCursorAimLatency, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TopDown Cursor Aim Latency (frames)"), STAT_TopDownCursorAimLatencyFrames, STATGROUP_Character);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("TopDown Camera Critical Path (ms)"), STAT_TopDownCameraCriticalPath, STATGROUP_Character);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("TopDown Camera Critical Path (ticks)"), STAT_TopDownCameraCriticalPathTicks, STATGROUP_Character);
+
+/** Length of the longest chain of tick functions ending in the given one. */
+static int32 GetTickChainLength(FTickFunction& TickFunction, int32 Depth = 0)
+{
+	// Guard against cycles, which the tick task manager would report anyway
+	if (Depth > 32)
+		return Depth;
+
+	int32 Length = 0;
+	for (FTickPrerequisite& Prerequisite : TickFunction.GetPrerequisites())
+	{
+		if (FTickFunction* PrerequisiteTickFunction = Prerequisite.Get())
+			Length = FMath::Max(Length, GetTickChainLength(*PrerequisiteTickFunction, Depth + 1));
+	}
+
+	return Length + 1;
+}
+
+void FTopDownCharacterPreMovementTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target && !Target->IsPendingKillOrUnreachable() && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Target->PreMovementUpdate(DeltaTime);
+	}
+}
+
+FString FTopDownCharacterPreMovementTickFunction::DiagnosticMessage()
+{
+	return Target ? Target->GetFullName() + TEXT("[PreMovementUpdate]") : TEXT("<NULL>[PreMovementUpdate]");
+}
+
+void FTopDownCharacterLateUpdateTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target && !Target->IsPendingKillOrUnreachable() && TickType != LEVELTICK_ViewportsOnly)
+	{
+		Target->LateUpdate(DeltaTime);
+	}
+}
+
+FString FTopDownCharacterLateUpdateTickFunction::DiagnosticMessage()
+{
+	return Target ? Target->GetFullName() + TEXT("[LateUpdate]") : TEXT("<NULL>[LateUpdate]");
+}
+
 ATopDownCharacter::ATopDownCharacter(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -59,10 +109,39 @@ ATopDownCharacter::ATopDownCharacter(const FObjectInitializer& ObjectInitializer
 	CameraBracket->bInheritRoll = false;
 	CameraBracket->SetIsReplicated(false);
 
+	CameraBracketTickGroup = TG_PostUpdateWork;
+	bCameraBracketTickAfterMovement = true;
+	CameraCriticalPathStartCycles = 0;
+
 	bDrawDebugMarkers = false;
 
 	// Mouse look
 	bUseMouseToLook = true;
+	bUseLateUpdateAim = false;
+	CursorAimLatencyTolerance = 1.0f;
+
+	LateUpdateTickFunction.bCanEverTick = true;
+	LateUpdateTickFunction.bStartWithTickEnabled = true;
+	LateUpdateTickFunction.bTickEvenWhenPaused = false;
+	LateUpdateTickFunction.TickGroup = TG_PostUpdateWork;
+
+	PreMovementTickFunction.bCanEverTick = true;
+	PreMovementTickFunction.bStartWithTickEnabled = true;
+	PreMovementTickFunction.bTickEvenWhenPaused = false;
+	PreMovementTickFunction.TickGroup = TG_PrePhysics;
+
+	CachedInvViewProjectionMatrix = FMatrix::Identity;
+	CachedViewFrame = 0;
+	LastCursorPosition = FVector2D::ZeroVector;
+	SyntheticCursorPosition = FVector2D::ZeroVector;
+	SyntheticViewportSize = FIntPoint::ZeroValue;
+	PendingAimYaw = 0.0f;
+	PendingAimStartTime = 0.0;
+	PendingAimStartFrame = 0;
+	LastCursorAimLatency = 0.0f;
+	LastCursorAimLatencyFrames = 0;
+	bHasPendingAim = false;
+	bUseSyntheticCursor = false;
 }
 
 void ATopDownCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -76,6 +155,15 @@ void ATopDownCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 	PlayerInputComponent->BindAction(TauntInputName, IE_Pressed, this, &ThisClass::PlayerInputTaunt);
 }
 
+void ATopDownCharacter::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	CameraBracket->SetTickGroup(CameraBracketTickGroup);
+	if (bCameraBracketTickAfterMovement)
+		CameraBracket->AddTickPrerequisiteComponent(GetCharacterMovement());
+}
+
 void ATopDownCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
@@ -104,6 +192,193 @@ void ATopDownCharacter::Tick(float DeltaTime)
 #endif
 }
 
+void ATopDownCharacter::RegisterActorTickFunctions(bool bRegister)
+{
+	Super::RegisterActorTickFunctions(bRegister);
+
+	if (bRegister)
+	{
+		if (LateUpdateTickFunction.bCanEverTick)
+		{
+			LateUpdateTickFunction.Target = this;
+			LateUpdateTickFunction.SetTickFunctionEnable(LateUpdateTickFunction.bStartWithTickEnabled);
+			LateUpdateTickFunction.RegisterTickFunction(GetLevel());
+
+			// Late update runs after the camera bracket so it can measure the critical path up to it
+			LateUpdateTickFunction.AddPrerequisite(CameraBracket, CameraBracket->PrimaryComponentTick);
+		}
+
+		if (PreMovementTickFunction.bCanEverTick)
+		{
+			PreMovementTickFunction.Target = this;
+			PreMovementTickFunction.SetTickFunctionEnable(PreMovementTickFunction.bStartWithTickEnabled);
+			PreMovementTickFunction.RegisterTickFunction(GetLevel());
+
+			// Character movement ticks before the character itself, so the control rotation has to be set in a tick it waits for
+			GetCharacterMovement()->PrimaryComponentTick.AddPrerequisite(this, PreMovementTickFunction);
+		}
+	}
+	else
+	{
+		if (LateUpdateTickFunction.IsTickFunctionRegistered())
+			LateUpdateTickFunction.UnRegisterTickFunction();
+
+		if (PreMovementTickFunction.IsTickFunctionRegistered())
+		{
+			GetCharacterMovement()->PrimaryComponentTick.RemovePrerequisite(this, PreMovementTickFunction);
+			PreMovementTickFunction.UnRegisterTickFunction();
+		}
+	}
+}
+
+void ATopDownCharacter::PreMovementUpdate(float DeltaTime)
+{
+	// Movement is the first step of the critical path up to the camera bracket
+	CameraCriticalPathStartCycles = FPlatformTime::Cycles64();
+
+	if (bUseLateUpdateAim)
+		UpdateLateUpdateAim();
+}
+
+void ATopDownCharacter::LateUpdate(float DeltaTime)
+{
+#if STATS
+	if (CameraCriticalPathStartCycles != 0)
+	{
+		SET_FLOAT_STAT(STAT_TopDownCameraCriticalPath, FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - CameraCriticalPathStartCycles));
+		SET_DWORD_STAT(STAT_TopDownCameraCriticalPathTicks, GetTickChainLength(CameraBracket->PrimaryComponentTick));
+		CameraCriticalPathStartCycles = 0;
+	}
+#endif
+
+	// Movement has already been applied so the facing checked here is the one rendered this frame
+	UpdateCursorAimLatency();
+}
+
+void ATopDownCharacter::UpdateLateUpdateAim()
+{
+	if (!bUseMouseToLook || !Controller || !Controller->IsLocalPlayerController())
+		return;
+
+	APlayerController* const PC = CastChecked<APlayerController>(Controller);
+
+	if (bIsPerformingGenericAction && InputComponent && InputEnabled())
+	{
+		FVector2D ScreenPosition;
+		FIntPoint ViewportSize;
+		FVector CursorLocation, CursorDirection, DesiredDirection;
+		if (GetCursorPosition(PC, ScreenPosition, ViewportSize)
+			&& DeprojectFromCachedView(PC, ScreenPosition, ViewportSize, CursorLocation, CursorDirection)
+			&& GetCursorAimDirection(CursorLocation, CursorDirection, DesiredDirection))
+		{
+			NoteCursorSample(ScreenPosition, DesiredDirection);
+
+			// Set the control rotation directly as rotation input is not used in this mode and would only be applied by the controller tick
+			if (!PC->IsLookInputIgnored())
+				PC->SetControlRotation(DesiredDirection.ToOrientationRotator());
+		}
+	}
+}
+
+bool ATopDownCharacter::GetCursorPosition(APlayerController* PC, FVector2D& OutScreenPosition, FIntPoint& OutViewportSize) const
+{
+	PC->GetViewportSize(OutViewportSize.X, OutViewportSize.Y);
+
+	if (bUseSyntheticCursor)
+	{
+		OutScreenPosition = SyntheticCursorPosition;
+		if (OutViewportSize.X <= 0 || OutViewportSize.Y <= 0)
+			OutViewportSize = SyntheticViewportSize;
+
+		return true;
+	}
+
+	return PC->GetMousePosition(OutScreenPosition.X, OutScreenPosition.Y);
+}
+
+bool ATopDownCharacter::DeprojectFromCachedView(APlayerController* PC, const FVector2D& ScreenPosition, const FIntPoint& ViewportSize, FVector& OutWorldLocation, FVector& OutWorldDirection)
+{
+	if (!PC->PlayerCameraManager || ViewportSize.X <= 0 || ViewportSize.Y <= 0)
+		return false;
+
+	// Build the matrix at most once per frame from the view the camera manager computed for the last rendered frame, which is what the
+	// cursor position refers to. Assumes the view covers the whole viewport which is the case for top-down games without split screen
+	// or letterboxing.
+	if (CachedViewFrame != GFrameCounter)
+	{
+		FMinimalViewInfo ViewInfo = PC->PlayerCameraManager->GetCameraCachePOV();
+		ViewInfo.AspectRatio = (float)ViewportSize.X / (float)ViewportSize.Y;
+
+		const FMatrix ViewMatrix = FTranslationMatrix(-ViewInfo.Location) * FInverseRotationMatrix(ViewInfo.Rotation) * FMatrix(
+			FPlane(0, 0, 1, 0),
+			FPlane(1, 0, 0, 0),
+			FPlane(0, 1, 0, 0),
+			FPlane(0, 0, 0, 1));
+
+		CachedInvViewProjectionMatrix = (ViewMatrix * ViewInfo.CalculateProjectionMatrix()).Inverse();
+		CachedViewFrame = GFrameCounter;
+	}
+
+	FSceneView::DeprojectScreenToWorld(ScreenPosition, FIntRect(0, 0, ViewportSize.X, ViewportSize.Y), CachedInvViewProjectionMatrix, OutWorldLocation, OutWorldDirection);
+	return true;
+}
+
+bool ATopDownCharacter::GetCursorAimDirection(const FVector& CursorLocation, const FVector& CursorDirection, FVector& OutDirection) const
+{
+	const FVector ActorLocation = GetActorLocation();
+	float OutDistance;
+	FVector Intersection;
+	if (Kismet::Math::RayPlaneIntersection(CursorLocation, CursorDirection, FPlane(FVector::UpVector, ActorLocation.Z), OutDistance, Intersection))
+	{
+		OutDirection = Intersection - ActorLocation;
+		return !OutDirection.IsNearlyZero();
+	}
+
+	return false;
+}
+
+void ATopDownCharacter::NoteCursorSample(const FVector2D& ScreenPosition, const FVector& DesiredDirection)
+{
+	if (ScreenPosition != LastCursorPosition)
+	{
+		LastCursorPosition = ScreenPosition;
+		PendingAimYaw = DesiredDirection.ToOrientationRotator().Yaw;
+
+		// Keep the start of a measurement that is still pending so continuous movement reports the full delay.
+		if (!bHasPendingAim)
+		{
+			PendingAimStartTime = FPlatformTime::Seconds();
+			PendingAimStartFrame = GFrameCounter;
+			bHasPendingAim = true;
+		}
+	}
+}
+
+void ATopDownCharacter::UpdateCursorAimLatency()
+{
+	if (bHasPendingAim && FMath::Abs(FMath::FindDeltaAngleDegrees(GetActorRotation().Yaw, PendingAimYaw)) <= CursorAimLatencyTolerance)
+	{
+		bHasPendingAim = false;
+		LastCursorAimLatency = FPlatformTime::Seconds() - PendingAimStartTime;
+		LastCursorAimLatencyFrames = GFrameCounter - PendingAimStartFrame;
+
+		SET_FLOAT_STAT(STAT_TopDownCursorAimLatency, LastCursorAimLatency * 1000.0f);
+		SET_DWORD_STAT(STAT_TopDownCursorAimLatencyFrames, LastCursorAimLatencyFrames);
+	}
+}
+
+void ATopDownCharacter::SetSyntheticCursor(FVector2D ScreenPosition, FIntPoint ViewportSize)
+{
+	SyntheticCursorPosition = ScreenPosition;
+	SyntheticViewportSize = ViewportSize;
+	bUseSyntheticCursor = true;
+}
+
+void ATopDownCharacter::ClearSyntheticCursor()
+{
+	bUseSyntheticCursor = false;
+}
+
 void ATopDownCharacter::ProcessInput(float DeltaTime, bool bGamePaused)
 {
 	// Handle aiming state and look direction
@@ -114,28 +389,27 @@ void ATopDownCharacter::ProcessInput(float DeltaTime, bool bGamePaused)
 		// input itself is what triggers the aim.
 		if (bUseMouseToLook)
 		{
-			if (bIsPerformingGenericAction)
+			// Late update aiming samples the cursor in the pre movement tick instead.
+			if (bIsPerformingGenericAction && !bUseLateUpdateAim)
 			{
-				FVector CursorLocation, CursorDirection;
 				APlayerController* const PC = CastChecked<APlayerController>(Controller);
-				if (PC->DeprojectMousePositionToWorld(CursorLocation, CursorDirection))
+
+				FVector2D ScreenPosition;
+				FIntPoint ViewportSize;
+				FVector CursorLocation, CursorDirection, DesiredDirection;
+				if (GetCursorPosition(PC, ScreenPosition, ViewportSize)
+					&& PC->DeprojectScreenPositionToWorld(ScreenPosition.X, ScreenPosition.Y, CursorLocation, CursorDirection)
+					&& GetCursorAimDirection(CursorLocation, CursorDirection, DesiredDirection))
 				{
-					const FVector ActorLocation = GetActorLocation();
-					float OutDistance;
-					FVector Intersection;
-					if (Kismet::Math::RayPlaneIntersection(CursorLocation, CursorDirection, FPlane(FVector::UpVector, ActorLocation.Z), OutDistance, Intersection))
-					{
-						const FVector DesiredDirection = Intersection - ActorLocation;
-
-						PlayerInputLook(DesiredDirection);
-					}
+					NoteCursorSample(ScreenPosition, DesiredDirection);
+					PlayerInputLook(DesiredDirection);
 				}
 			}
 		}
 		else
 		{
-			// const float LookRightValue = InputComponent->GetAxisValue(LookRightInputName);
-			// const float LookUpValue = InputComponent->GetAxisValue(LookUpInputName);
+			// const float LookRightValue = GetInputState().LookRight;
+			// const float LookUpValue = GetInputState().LookUp;
 
 			// if (LookRightValue == 0.0f && LookUpValue == 0.0f)
 			// {
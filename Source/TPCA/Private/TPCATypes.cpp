@@ -1,6 +1,10 @@
 // This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
 
 #include "TPCATypes.h"
+#include "Engine/ActorChannel.h"
+#include "Engine/NetConnection.h"
+#include "Engine/PackageMapClient.h"
+#include "GameFramework/Actor.h"
 
 const FName NAME_Spectator(TEXT("Spectator"));
 const FName NAME_Normal(TEXT("Normal"));
@@ -42,3 +46,132 @@ void SerializeQuantizedRotator(FArchive& Ar, FRotator& Rotator, ERotatorQuantiza
 		break;
 	}
 }
+
+FVector QuantizeVector(const FVector& Vector, EVectorQuantization QuantizationLevel)
+{
+	// Matches the rounding of SerializePackedVector for the scale used by each level in SerializeQuantizedVector
+	float Scale;
+	switch (QuantizationLevel)
+	{
+	case EVectorQuantization::RoundTwoDecimals:
+		Scale = 100.f;
+		break;
+	case EVectorQuantization::RoundOneDecimal:
+		Scale = 10.f;
+		break;
+	default:
+		Scale = 1.f;
+		break;
+	}
+
+	return FVector(
+		FMath::RoundToInt(Vector.X * Scale) / Scale,
+		FMath::RoundToInt(Vector.Y * Scale) / Scale,
+		FMath::RoundToInt(Vector.Z * Scale) / Scale);
+}
+
+FRotator QuantizeRotator(const FRotator& Rotator, ERotatorQuantization QuantizationLevel)
+{
+	switch (QuantizationLevel)
+	{
+	case ERotatorQuantization::ByteComponents:
+		return FRotator(
+			FRotator::DecompressAxisFromByte(FRotator::CompressAxisToByte(Rotator.Pitch)),
+			FRotator::DecompressAxisFromByte(FRotator::CompressAxisToByte(Rotator.Yaw)),
+			FRotator::DecompressAxisFromByte(FRotator::CompressAxisToByte(Rotator.Roll)));
+	case ERotatorQuantization::ShortComponents:
+		return FRotator(
+			FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotator.Pitch)),
+			FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotator.Yaw)),
+			FRotator::DecompressAxisFromShort(FRotator::CompressAxisToShort(Rotator.Roll)));
+	}
+
+	return Rotator;
+}
+
+/** Round a unit vector component to the value SerializeFixedVector<1, 16> produces on the receiving end. */
+static float QuantizeFixedUnitFloat(float Value)
+{
+	static const float MaxBitValue = float((1 << 15) - 1);
+	return FMath::RoundToInt(FMath::Clamp(Value, -1.f, 1.f) * MaxBitValue) / MaxBitValue;
+}
+
+void FRepExtMovement::Quantize()
+{
+	Location = QuantizeVector(Location, LocationQuantizationLevel);
+	Rotation = QuantizeRotator(Rotation, RotationQuantizationLevel);
+	Velocity = QuantizeVector(Velocity, VelocityQuantizationLevel);
+	Acceleration = FVector(QuantizeFixedUnitFloat(Acceleration.X), QuantizeFixedUnitFloat(Acceleration.Y), QuantizeFixedUnitFloat(Acceleration.Z));
+}
+
+bool FRepExtMovement::IsNearlyEqual(const FRepExtMovement& Other, float LocationError, float RotationError, float VelocityError, float AccelerationError) const
+{
+	if (bIsPivotTurning != Other.bIsPivotTurning || bTurnInPlacePredicted != Other.bTurnInPlacePredicted || bAccelerationDerived != Other.bAccelerationDerived
+		|| bAccelerationAlongVelocity != Other.bAccelerationAlongVelocity)
+		return false;
+
+	if (!bTurnInPlacePredicted && TurnInPlaceTargetYaw != Other.TurnInPlaceTargetYaw)
+		return false;
+
+	// Starting or stopping is always a change, however small, since proxies would otherwise keep extrapolating or stay at rest
+	if (Velocity.IsZero() != Other.Velocity.IsZero() || Acceleration.IsZero() != Other.Acceleration.IsZero())
+		return false;
+
+	const FRotator RotationDelta = (Rotation - Other.Rotation).GetNormalized();
+	return Location.Equals(Other.Location, LocationError)
+		&& FMath::Abs(RotationDelta.Pitch) <= RotationError
+		&& FMath::Abs(RotationDelta.Yaw) <= RotationError
+		&& FMath::Abs(RotationDelta.Roll) <= RotationError
+		&& Velocity.Equals(Other.Velocity, VelocityError)
+		&& Acceleration.Equals(Other.Acceleration, AccelerationError);
+}
+
+/** True if the client on the other end of the package map can resolve a reference to the actor without waiting for it to become relevant. */
+static bool CanReferenceActor(UPackageMap* Map, AActor* Actor)
+{
+	// Actors loaded with the level are referenced by path
+	if (Actor->IsFullNameStableForNetworking())
+		return true;
+
+	UPackageMapClient* PackageMapClient = Cast<UPackageMapClient>(Map);
+	UNetConnection* Connection = PackageMapClient ? PackageMapClient->GetConnection() : nullptr;
+
+	// No connection to check against, e.g. when recording a replay
+	if (!Connection)
+		return true;
+
+	return Connection->FindActorChannelRef(Actor) != nullptr;
+}
+
+bool FRepLookAt::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+	bOutSuccess = true;
+
+	uint8 bSerializedHasTarget = bHasTarget;
+	Ar.SerializeBits(&bSerializedHasTarget, 1);
+
+	uint8 bSerializedActor = Ar.IsSaving() && bHasTarget && Actor && CanReferenceActor(Map, Actor);
+	if (bSerializedHasTarget)
+		Ar.SerializeBits(&bSerializedActor, 1);
+
+	if (Ar.IsLoading())
+	{
+		bHasTarget = bSerializedHasTarget;
+		if (!bSerializedActor)
+			Actor = nullptr;
+	}
+
+	if (bSerializedActor)
+	{
+		UObject* Object = Actor;
+		bOutSuccess &= Map->SerializeObject(Ar, AActor::StaticClass(), Object);
+		if (Ar.IsLoading())
+			Actor = Cast<AActor>(Object);
+	}
+
+	// Location is sent along with the actor too since the reference may not resolve on the client, e.g. if it stopped being relevant
+	if (bSerializedHasTarget)
+		bOutSuccess &= SerializePackedVector<1, 24>(Location, Ar);
+
+	return true;
+}
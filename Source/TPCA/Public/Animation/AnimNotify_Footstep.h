@@ -0,0 +1,74 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "Animation/AnimNotifies/AnimNotify.h"
+
+#include "AnimNotify_Footstep.generated.h"
+
+class UPhysicalMaterial;
+class USoundBase;
+
+/**
+ * Plays a footstep sound for the surface the character is walking on.
+ * The surface comes from the floor already found by the character movement so no trace is done. Footsteps that are out of range of every
+ * listener or over the concurrency limit are culled before anything else. Sounds are played through UFootstepSubsystem's pool.
+ */
+UCLASS(meta = (DisplayName = "Footstep"))
+class TPCA_API UAnimNotify_Footstep : public UAnimNotify
+{
+	GENERATED_BODY()
+
+public:
+
+	UAnimNotify_Footstep();
+
+	/** Sound played for each surface type. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AnimNotify")
+	TMap<TEnumAsByte<EPhysicalSurface>, USoundBase*> SurfaceSounds;
+
+	/** Sound played when the surface has no entry in SurfaceSounds. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AnimNotify")
+	USoundBase* DefaultSound;
+
+	/** If true the sound plays at the right foot of an ExtCharacter, otherwise at the left foot. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AnimNotify")
+	bool bRightFoot;
+
+	/** Bone or socket the sound plays at. Overrides the foot bones of ExtCharacter if set. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AnimNotify", AdvancedDisplay)
+	FName SocketName;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AnimNotify")
+	float VolumeMultiplier;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AnimNotify")
+	float PitchMultiplier;
+
+	/** Footsteps further than this from every listener are culled. Zero disables distance culling. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AnimNotify|Culling", meta = (ClampMin = "0", UIMin = "0"))
+	float MaxDistance;
+
+	/** Footsteps are culled while this many are already playing in the world. Zero disables concurrency culling. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AnimNotify|Culling", meta = (ClampMin = "0", UIMin = "0"))
+	int32 MaxConcurrent;
+
+	//~Begin UAnimNotify
+	virtual FString GetNotifyName_Implementation() const override;
+	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) override;
+	//~End UAnimNotify
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+
+	/** Physical material to sound, so SurfaceSounds is only searched once per material. Notifies are shared by all instances. */
+	mutable TMap<TWeakObjectPtr<const UPhysicalMaterial>, USoundBase*> SoundCache;
+
+	USoundBase* GetSoundForMaterial(const UPhysicalMaterial* PhysMaterial) const;
+};
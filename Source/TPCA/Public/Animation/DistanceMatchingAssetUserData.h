@@ -0,0 +1,78 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Engine/AssetUserData.h"
+
+#include "DistanceMatchingAssetUserData.generated.h"
+
+class UAnimSequenceBase;
+
+/**
+ * Precomputed root motion distance data attached to an animation sequence.
+ * Generated offline by the DistanceMatching commandlet and queried at runtime in constant time, without searching curves by name.
+ *
+ * Distances are measured along the root motion path from the start of the animation, so they are always increasing.
+ */
+UCLASS()
+class TPCA_API UDistanceMatchingAssetUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+
+	UDistanceMatchingAssetUserData();
+
+	/** Time between consecutive distance samples. */
+	UPROPERTY(VisibleAnywhere, Category = "Distance Matching")
+	float TimeStep;
+
+	/** Time of the last distance sample, the length of the animation. The last sample can be closer than TimeStep to the one before it. */
+	UPROPERTY(VisibleAnywhere, Category = "Distance Matching")
+	float PlayLength;
+
+	/** Distance between consecutive time samples in the inverse table. */
+	UPROPERTY(VisibleAnywhere, Category = "Distance Matching")
+	float DistanceStep;
+
+	/** Total distance travelled by the root bone over the whole animation. */
+	UPROPERTY(VisibleAnywhere, Category = "Distance Matching")
+	float TotalDistance;
+
+	/** Hash of the source animation data these tables were built from. Used to skip up to date animations. */
+	UPROPERTY(VisibleAnywhere, Category = "Distance Matching")
+	FString SourceHash;
+
+	/** Distance travelled at each multiple of TimeStep, then at PlayLength. */
+	UPROPERTY()
+	TArray<float> Distances;
+
+	/** Animation time at each multiple of DistanceStep, then at TotalDistance. */
+	UPROPERTY()
+	TArray<float> Times;
+
+	/** Fill both tables from distances sampled at a uniform time step, with the last sample at InPlayLength. */
+	void Build(const TArray<float>& InDistances, float InTimeStep, float InPlayLength, float InDistanceStep);
+
+	/** Animation time at which the root has travelled the given distance. */
+	float GetTimeFromDistance(float Distance) const;
+
+	/** Animation time at which the root is the given distance away from its final position. */
+	float GetTimeFromDistanceRemaining(float DistanceRemaining) const;
+
+	/** Distance travelled by the root at the given animation time. */
+	float GetDistanceFromTime(float Time) const;
+
+	/** Find the distance matching data of an animation if it has been generated. */
+	static UDistanceMatchingAssetUserData* Find(const UAnimSequenceBase* AnimSequence);
+
+private:
+
+	/** Time of the last distance sample. Data built before PlayLength was stored assumed it to be a multiple of TimeStep. */
+	float GetLastSampleTime() const;
+
+	/** Interpolate samples taken at each multiple of Step, with the last one at LastKey. */
+	static float SampleUniform(const TArray<float>& Samples, float Step, float LastKey, float Key);
+};
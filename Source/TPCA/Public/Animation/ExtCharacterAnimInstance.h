@@ -47,6 +47,119 @@ struct FootIKOffset
 	{}
 };
 
+/**
+ * Snapshot of the character state consumed by UExtCharacterAnimInstance::NativeUpdateAnimation.
+ * Used to detect frames in which nothing relevant to the animation has changed.
+ */
+struct FExtCharacterAnimInputs
+{
+	FVector MeshLocation;
+	FVector Velocity;
+	FVector Acceleration;
+	FVector LookAtLocation;
+	FRotator CharacterRotation;
+	FRotator LookRotation;
+	AActor* LookAtActor;
+	float TurnInPlaceTargetYaw;
+	TEnumAsByte<EMovementMode> MovementMode;
+	uint8 CustomMovementMode;
+	ECharacterGait Gait;
+	ECharacterRotationMode RotationMode;
+	ETurnInPlaceState TurnInPlaceState;
+	uint8 bIsCrouched : 1;
+	uint8 bIsJumping : 1;
+	uint8 bIsPerformingGenericAction : 1;
+	uint8 bIsPivotTurning : 1;
+	uint8 bIsRagdoll : 1;
+	uint8 bIsGettingUp : 1;
+
+	FExtCharacterAnimInputs():
+		MeshLocation(ForceInitToZero),
+		Velocity(ForceInitToZero),
+		Acceleration(ForceInitToZero),
+		LookAtLocation(ForceInitToZero),
+		CharacterRotation(ForceInitToZero),
+		LookRotation(ForceInitToZero),
+		LookAtActor(nullptr),
+		TurnInPlaceTargetYaw(0.0f),
+		MovementMode(MOVE_None),
+		CustomMovementMode(0),
+		Gait(ECharacterGait::Walk),
+		RotationMode(ECharacterRotationMode::None),
+		TurnInPlaceState(ETurnInPlaceState::Done),
+		bIsCrouched(false),
+		bIsJumping(false),
+		bIsPerformingGenericAction(false),
+		bIsPivotTurning(false),
+		bIsRagdoll(false),
+		bIsGettingUp(false)
+	{}
+
+	bool operator==(const FExtCharacterAnimInputs& Other) const
+	{
+		return MeshLocation == Other.MeshLocation
+			&& Velocity == Other.Velocity
+			&& Acceleration == Other.Acceleration
+			&& LookAtLocation == Other.LookAtLocation
+			&& CharacterRotation == Other.CharacterRotation
+			&& LookRotation == Other.LookRotation
+			&& LookAtActor == Other.LookAtActor
+			&& TurnInPlaceTargetYaw == Other.TurnInPlaceTargetYaw
+			&& MovementMode == Other.MovementMode
+			&& CustomMovementMode == Other.CustomMovementMode
+			&& Gait == Other.Gait
+			&& RotationMode == Other.RotationMode
+			&& TurnInPlaceState == Other.TurnInPlaceState
+			&& bIsCrouched == Other.bIsCrouched
+			&& bIsJumping == Other.bIsJumping
+			&& bIsPerformingGenericAction == Other.bIsPerformingGenericAction
+			&& bIsPivotTurning == Other.bIsPivotTurning
+			&& bIsRagdoll == Other.bIsRagdoll
+			&& bIsGettingUp == Other.bIsGettingUp;
+	}
+
+	bool operator!=(const FExtCharacterAnimInputs& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+/**
+ * Turn in place animation positions sampled from the turn in place curves of an anim class, indexed by
+ * stance, direction, length and quantized remaining yaw. Built once per anim class and shared by all its instances.
+ */
+struct TPCA_API FExtCharacterTurnInPlaceTable
+{
+	enum EStance
+	{
+		Normal,
+		LeftFootFwd,
+		Crouched,
+		NumStances
+	};
+
+	/** Number of samples per degree of remaining yaw. */
+	static const int32 SamplesPerDegree;
+
+	/** Samples for each [Stance][bRight][bLong]. Only the normal stance has long turns. Empty when the corresponding curve is not set. */
+	TArray<float> Samples[NumStances][2][2];
+
+	void Build(const class UExtCharacterAnimInstance* AnimDefaults);
+
+	/** Anim position for the given remaining yaw, in degrees. Negative values are expected when turning left. */
+	float Evaluate(EStance Stance, bool bRight, bool bLong, float TargetDeltaRemaining) const
+	{
+		const TArray<float>& Table = Samples[Stance][bRight][bLong];
+		if (Table.Num() == 0)
+			return 0.f;
+
+		const float Range = bLong ? 180.f : 90.f;
+		const float Position = FMath::Abs(FMath::Fmod(TargetDeltaRemaining, Range)) * SamplesPerDegree;
+		const int32 Index = FMath::Min(FMath::FloorToInt(Position), Table.Num() - 2);
+		return FMath::Lerp(Table[Index], Table[Index + 1], Position - Index);
+	}
+};
+
 /**
  * AnimInstance base class to be used specifically with an ExtCharacter.
  * It has been designed to work with the following restrictions:
@@ -93,6 +206,34 @@ private:
 	uint32 bHasGaitChanged : 1;
 	uint32 bHasPerformingGenericActionChanged : 1;
 
+	/** True while a movement mode change is waiting to interrupt montages. */
+	uint32 bHasPendingMontageInterrupt : 1;
+
+	/** Movement mode before the pending montage interrupt. Changing back to it cancels the interrupt. */
+	TEnumAsByte<EMovementMode> MontageInterruptFromMode;
+	uint8 MontageInterruptFromCustomMode;
+
+	/** World time of the movement mode change that raised the pending montage interrupt. */
+	float MontageInterruptTime;
+
+	/** Instance IDs of the montages that were active when the pending montage interrupt was raised. Montages started later are kept. */
+	TArray<int32> MontageInterruptInstanceIDs;
+
+	/** Number of montages stopped by movement mode changes since initialization. */
+	int32 NumMontagesStoppedByMovementMode;
+
+	/** Inputs gathered from the character in the last update. */
+	FExtCharacterAnimInputs LastInputs;
+
+	/** Number of consecutive updates in which the gathered inputs did not change. */
+	int32 UnchangedInputsCount;
+
+	/** Turn in place table shared by all instances of this class. Only built and held by the class default object. */
+	mutable TSharedPtr<FExtCharacterTurnInPlaceTable> TurnInPlaceTable;
+
+	/** Interpolation speed selected for the aim offset in the last full update. */
+	float AimOffsetCurrentInterpSpeed;
+
 	/** Used to adjust the root bone rotation when in ragdoll */
 	FQuat RootBoneRotation;
 
@@ -510,6 +651,28 @@ private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings|Walking", meta = (AllowPrivateAccess = "true"))
 	float ForceVelocityScale;
 
+	/**
+	 * If true, skip recomputing derived values while the character is settled (not moving, turning, pivoting or in ragdoll)
+	 * and none of its animation inputs changed since the last update. Only the time-based interpolators are advanced.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings|Optimization", meta = (AllowPrivateAccess = "true"))
+	bool bSkipUpdateWhenInputsUnchanged;
+
+	/** Movement modes that stop montages without a Montage Interrupt Policy when the character changes to them. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings|Montages", meta = (AllowPrivateAccess = "true", Bitmask, BitmaskEnum = "EMovementMode"))
+	int32 DefaultMontageInterruptingMovementModes;
+
+	/**
+	 * Time the character must keep falling before montages are stopped, unless overridden by their Montage Interrupt Policy.
+	 * Filters out transient falling when stepping off small ledges or crossing walkable edges. Zero stops them right away.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings|Montages", meta = (AllowPrivateAccess = "true", ClampMin = "0", UIMin = "0"))
+	float FallingMontageInterruptDelay;
+
+	/** Blend out time of montages stopped by a movement mode change. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Settings|Montages", meta = (AllowPrivateAccess = "true", ClampMin = "0", UIMin = "0"))
+	float MontageInterruptBlendOutTime;
+
 protected:
 
 	/** Numeric representation of the current gait (walk/run/sprint) in the range [0, 3] according to the configured speeds. **/
@@ -603,13 +766,32 @@ protected:
 	virtual void NativeInitializeAnimation() override;
 	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
 
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
 	virtual void NativeUpdateGaitScale(float DeltaSeconds);
 	virtual void NativeUpdatePivotTurn(const FVector& InLastVelocity, float DeltaSeconds);
 	virtual void NativeUpdateTurnInPlace(float DeltaSeconds);
 	virtual void NativeUpdateAimOffset(float DeltaSeconds);
 
+	/** Fill the snapshot of character state that drives the animation update. */
+	virtual void GatherInputs(FExtCharacterAnimInputs& OutInputs) const;
+
+	/** True if the derived values computed in the last update are still valid for the given inputs. */
+	virtual bool CanSkipDerivedUpdate(const FExtCharacterAnimInputs& Inputs) const;
+
+	/** Advance only the time-based interpolators. Used when the derived update is skipped. */
+	virtual void NativeUpdateInterpolators(float DeltaSeconds);
+
+	/** Copy settings from the character that are not part of FExtCharacterAnimInputs so that changes apply even while the update is skipped. */
+	virtual void NativeUpdateCharacterSettings();
+
 	virtual void RaiseEvents();
 
+	/** Stop the active montages whose interrupt policy matches the pending movement mode change once its delay has elapsed. */
+	virtual void UpdateMontageInterrupts();
+
 	void SetMovementMode(const EMovementMode Value, const uint8 CustomValue);
 	void SetCrouched(const bool Value);
 	void SetGait(const ECharacterGait Value);
@@ -646,6 +828,23 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = Animation)
 	float FindCurveTimeFromValue(UAnimSequence* InAnimSequence, const FName CurveName, const float Value) const;
 
+	/**
+	 * Retrieves the time within the provided animation sequence at which the root has travelled the given distance or, if bRemaining is true,
+	 * at which the root is the given distance away from its final position. Uses the data generated by the DistanceMatching commandlet.
+	 * Returns 0 if the animation has no distance matching data.
+	 */
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = Animation)
+	float FindTimeFromDistance(UAnimSequence* InAnimSequence, const float Distance, const bool bRemaining = false) const;
+
+	/** Get the turn in place table shared by all instances of this class, building it if needed. */
+	const FExtCharacterTurnInPlaceTable& GetTurnInPlaceTable() const;
+
+	/** Discard the shared turn in place table so it's rebuilt on next use. Call after modifying any of the turn in place curves. */
+	void InvalidateTurnInPlaceTable();
+
+	/** Number of montages stopped by movement mode changes since initialization. */
+	FORCEINLINE int32 GetNumMontagesStoppedByMovementMode() const { return NumMontagesStoppedByMovementMode; }
+
 	FORCEINLINE AExtCharacter* GetCharacterOwner() const { return CharacterOwner; }
 
 	FORCEINLINE UExtCharacterMovementComponent* GetCharacterOwnerMovement() const { return CharacterOwnerMovement; }
@@ -0,0 +1,74 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "FootstepSubsystem.generated.h"
+
+class UAudioComponent;
+class USoundBase;
+
+/**
+ * Plays footstep sounds for every character in a world from a pool of audio components.
+ * Footsteps are culled against the audio listeners and the number of footsteps already playing before any work is done, so characters
+ * nobody can hear only pay for a distance check.
+ */
+UCLASS()
+class TPCA_API UFootstepSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UFootstepSubsystem();
+
+	//~Begin USubsystem
+	virtual void Deinitialize() override;
+	//~End USubsystem
+
+	/** Returns true if a footstep at the given location would be heard. Counts it as culled otherwise. */
+	bool ShouldPlayFootstep(const FVector& Location, float MaxDistance, int32 MaxConcurrent);
+
+	/** Play a sound at the given location using a pooled audio component. */
+	void PlayFootstep(USoundBase* Sound, const FVector& Location, float VolumeMultiplier, float PitchMultiplier);
+
+	/** Footsteps played during the last second. */
+	FORCEINLINE int32 GetFootstepsPerSecond() const { return LastFootstepsPerSecond; }
+
+	/** Footsteps culled during the last second. */
+	FORCEINLINE int32 GetCulledFootstepsPerSecond() const { return LastCulledPerSecond; }
+
+protected:
+
+	//~Begin USubsystem
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	//~End USubsystem
+
+private:
+
+	/** Audio components owned by the pool. Components that finished playing are reused. */
+	UPROPERTY(Transient)
+	TArray<UAudioComponent*> AudioComponents;
+
+	/** Audio listener locations, refreshed once per frame. */
+	TArray<FVector> ListenerLocations;
+	uint64 ListenerLocationsFrame;
+
+	/** Number of pooled components currently playing, refreshed once per frame. */
+	int32 NumPlaying;
+	uint64 NumPlayingFrame;
+
+	double StatsWindowStartTime;
+	int32 FootstepsInWindow;
+	int32 CulledInWindow;
+	int32 LastFootstepsPerSecond;
+	int32 LastCulledPerSecond;
+
+	void UpdateListenerLocations();
+	void UpdateNumPlaying();
+	void UpdateStatsWindow();
+	UAudioComponent* AcquireAudioComponent();
+};
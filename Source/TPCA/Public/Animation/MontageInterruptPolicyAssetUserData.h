@@ -0,0 +1,43 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Engine/AssetUserData.h"
+#include "Engine/EngineTypes.h"
+
+#include "MontageInterruptPolicyAssetUserData.generated.h"
+
+class UAnimMontage;
+
+/**
+ * Declares which movement mode changes interrupt a montage played on a UExtCharacterAnimInstance.
+ * Montages without this data use the defaults of the anim instance.
+ */
+UCLASS(meta = (DisplayName = "Montage Interrupt Policy"))
+class TPCA_API UMontageInterruptPolicyAssetUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+
+public:
+
+	UMontageInterruptPolicyAssetUserData();
+
+	/** Movement modes that stop the montage when the character changes to them. */
+	UPROPERTY(EditAnywhere, Category = "Montage Interrupt Policy", meta = (Bitmask, BitmaskEnum = "EMovementMode"))
+	int32 InterruptingMovementModes;
+
+	/**
+	 * Time the character must keep falling before the montage is stopped. Falling for less than this, e.g. when stepping off a small ledge,
+	 * does not interrupt the montage. Negative values use the anim instance default.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Montage Interrupt Policy")
+	float FallingInterruptDelay;
+
+	/** True if changing to the given movement mode interrupts the montage. */
+	FORCEINLINE bool IsInterruptedBy(EMovementMode Mode) const { return (InterruptingMovementModes & (1 << Mode)) != 0; }
+
+	/** Find the interrupt policy of a montage if it has one. */
+	static UMontageInterruptPolicyAssetUserData* Find(const UAnimMontage* Montage);
+};
@@ -29,6 +29,43 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FRotationModeChangedSignature, AExtC
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FRagdollChangedSignature, AExtCharacter*, Sender);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FHitReactSignature, AExtCharacter*, Sender, ECardinalDirection, HitDirection, AActor*, DamageCauser);
 
+DECLARE_MULTICAST_DELEGATE_OneParam(FGenericActionChangedNativeSignature, AExtCharacter* /*Sender*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FCrouchChangedNativeSignature, AExtCharacter* /*Sender*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FGaitChangedNativeSignature, AExtCharacter* /*Sender*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FRotationModeChangedNativeSignature, AExtCharacter* /*Sender*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FRagdollChangedNativeSignature, AExtCharacter* /*Sender*/);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FHitReactNativeSignature, AExtCharacter* /*Sender*/, ECardinalDirection /*HitDirection*/, AActor* /*DamageCauser*/);
+
+/**
+ * Player input of an AExtCharacter as last received by its input bindings.
+ * Axes are written every frame by the input component so reading them here avoids searching the axis bindings by name.
+ */
+struct FExtCharacterInputState
+{
+	float MoveForward = 0.0f;
+	float MoveRight = 0.0f;
+	float LookUp = 0.0f;
+	float LookRight = 0.0f;
+
+	uint8 bCrouchPressed : 1;
+	uint8 bJumpPressed : 1;
+	uint8 bWalkPressed : 1;
+	uint8 bSprintPressed : 1;
+	uint8 bGenericActionPressed : 1;
+
+	FExtCharacterInputState()
+		: bCrouchPressed(false)
+		, bJumpPressed(false)
+		, bWalkPressed(false)
+		, bSprintPressed(false)
+		, bGenericActionPressed(false)
+	{
+	}
+
+	FORCEINLINE FVector2D GetMoveInput() const { return FVector2D(MoveForward, MoveRight); }
+	FORCEINLINE FVector2D GetLookInput() const { return FVector2D(LookUp, LookRight); }
+};
+
 // UP NEXT
 // ---------------------------------
 // TODO: Comment all methods with All/Local/Server to indicate where they are expected to be called
@@ -228,6 +265,14 @@ public:		// Bitfields
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Ragdoll)
 	uint32 bIgnoreLookInputWhenRagdoll : 1;
 
+	/**
+	 * If true crouch, walk, sprint and generic action input only records the intent, and all intents received in a frame are applied once
+	 * right before the movement update. Presses and releases that cancel out within a frame never reach the movement component, except
+	 * for generic action presses which are kept until applied, like Jump.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Input, AdvancedDisplay)
+	uint32 bBufferInputIntents : 1;
+
 	/** Stop movement immediately when unpossessed. This has no effect on a ragdoll.  */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Character)
 	uint32 bStopWhenUnpossessed : 1;
@@ -340,6 +385,46 @@ private:	// Variables
 	/* Handle for the timer triggered when getting up from ragdoll. */
 	FTimerHandle GettingUpTimerHandle;
 
+	/** [local] Player input received this frame. Filled by the PlayerInput* handlers. */
+	FExtCharacterInputState InputState;
+
+	/** [local] Action intents last applied by ApplyInputIntents(). */
+	FExtCharacterInputState AppliedInputIntents;
+
+	/** [local] True if generic action was pressed since the last ApplyInputIntents(), even if already released. */
+	uint8 bGenericActionPressLatched : 1;
+
+	/** Look rotation of the character. Follows the control rotation on the server and owning client, smoothed from ReplicatedLook on simulated proxies. */
+	FRotator CurrentLookRotation;
+
+	/** [server] World time ReplicatedLook was last changed. */
+	float LastLookReplicationTime;
+
+	/** [simulated] Angular velocity in deg/s estimated from the last two ReplicatedLook updates. */
+	FRotator ProxyLookAngularVelocity;
+
+	/** [server] World time the location in ReplicatedLookAt was last updated. */
+	float LastLookAtLocationUpdateTime;
+
+	/** [simulated] Last ReplicatedLook rotation received. */
+	FRotator LastReceivedLookRotation;
+
+	/** [simulated] World time the last ReplicatedLook update was received. Negative until the first one. */
+	float ProxyLookReceiveTime;
+
+	/** [server] Cached line of sight from a viewer, see RelevancyVisibilityInterval. */
+	struct FRelevancyVisibility
+	{
+		float UpdateTime;
+		bool bVisible;
+	};
+
+	/** [server] Line of sight results per viewer. Filled from IsNetRelevantFor, which is const. */
+	mutable TMap<TWeakObjectPtr<const AActor>, FRelevancyVisibility> RelevancyVisibilityCache;
+
+	/** [server] World time stale viewers are next removed from RelevancyVisibilityCache. */
+	mutable float NextRelevancyVisibilityPruneTime;
+
 #if WITH_EDITORONLY_DATA
 
 	/** Component shown in the editor only to indicate Look Rotation */
@@ -377,6 +462,13 @@ protected:
 	UPROPERTY(Transient, ReplicatedUsing=OnRep_ReplicatedExtMovementMode)
 	uint8 ReplicatedExtMovementMode;
 
+	/**
+	 * ReplicatedExtMovementMode, RotationMode, bIsWalkingInsteadOfRunning, bIsSprinting and bIsPerformingGenericAction packed in a single
+	 * property. Replicated instead of the separate properties when bCompactReplicatedState is true.
+	 */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_ReplicatedExtState)
+	uint16 ReplicatedExtState;
+
 public:		// Variables
 
 	/** Custom replicated movement. */
@@ -391,6 +483,10 @@ public:		// Variables
 	UPROPERTY(BlueprintReadOnly, Transient, Replicated, Category = Character, meta = (AllowPrivateAccess = "true", DisplayName = "LookAtActor"))
 	class AActor* ReplicatedLookAtActor;
 
+	/** Look at target replicated instead of ReplicatedLookAtActor when bRelevancyAwareLookAt is true. */
+	UPROPERTY(Transient, ReplicatedUsing = OnRep_ReplicatedLookAt)
+	FRepLookAt ReplicatedLookAt;
+
 	/** Speed in cm/s to look up/down after player input input. Use 0 for instant. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Input)
 	float LookUpInputSpeed;
@@ -399,6 +495,124 @@ public:		// Variables
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Input)
 	float LookRightInputSpeed;
 
+	/** [server] Look rotation changes smaller than this many degrees (in yaw and pitch) are not replicated. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+	float LookReplicationDeadBand;
+
+	/** [server] Maximum number of look rotation updates per second. Use 0 for no limit. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+	float LookReplicationMaxRate;
+
+	/** [simulated] Speed at which the look rotation of simulated proxies approaches its predicted target. Use 0 to snap to replicated values. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+	float LookSmoothingSpeed;
+
+	/** [simulated] Maximum time the look rotation of simulated proxies is extrapolated along its last angular velocity without new updates. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+	float LookPredictionMaxTime;
+
+	/**
+	 * [server] If true the look at actor is only sent to connections it is replicated to. Other connections receive its location instead,
+	 * updated at most LookAtLocationUpdateRate times per second.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, AdvancedDisplay)
+	bool bRelevancyAwareLookAt;
+
+	/** [server] Maximum number of look at location updates per second when bRelevancyAwareLookAt is true. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+	float LookAtLocationUpdateRate;
+
+	/** [server] The look at location is not updated until the look at actor moves farther than this from it. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+	float LookAtLocationTolerance;
+
+	/**
+	 * [server] Replicate movement mode, jump state, rotation mode and the walk, sprint and generic action flags packed in ReplicatedExtState
+	 * with a single change check and rep notify, instead of as separate properties.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, AdvancedDisplay)
+	bool bCompactReplicatedState;
+
+	/**
+	 * [server] Location changes up to this distance are not replicated. ReplicatedExtMovement is always compared after quantization,
+	 * so changes below the quantization step of each field are never replicated even when all thresholds are 0.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+	float ExtMovementLocationThreshold;
+
+	/** [server] Rotation changes up to this many degrees per component are not replicated. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+	float ExtMovementRotationThreshold;
+
+	/** [server] Velocity changes up to this many cm/s per component are not replicated. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+	float ExtMovementVelocityThreshold;
+
+	/** [server] Changes of the acceleration direction up to this much per component are not replicated. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0", ClampMax = "1", UIMax = "1"), AdvancedDisplay)
+	float ExtMovementAccelerationThreshold;
+
+	/**
+	 * [simulated] Apply ReplicatedExtMovement to the movement component directly instead of going through ReplicatedMovement and
+	 * OnRep_ReplicatedMovement. Updates within ProxyReceiveLocationTolerance and ProxyReceiveRotationTolerance of the current transform
+	 * only refresh velocity and the extended fields, skipping the transform update and smoothing correction.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, AdvancedDisplay)
+	bool bDirectProxyReceive;
+
+	/** [simulated] Location updates closer than this to the current location are not applied when bDirectProxyReceive is true. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+	float ProxyReceiveLocationTolerance;
+
+	/** [simulated] Rotation updates within this many degrees of the current rotation are not applied when bDirectProxyReceive is true. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Replication, meta = (ClampMin = "0", UIMin = "0"), AdvancedDisplay)
+	float ProxyReceiveRotationTolerance;
+
+	/**
+	 * [server] Scale NetCullDistanceSquared per connection by how noticeable the character is to the viewer: gait, crouch, ragdoll, whether
+	 * it looks at or targets the viewer and a cached line of sight test that ignores pawns. Owner, view target and movement base rules of
+	 * APawn are kept. Off by default since the default scales change relevancy ranges.
+	 * @see GetNetRelevancyDistanceScale()
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication|Relevancy", AdvancedDisplay)
+	bool bUseExtNetRelevancy;
+
+	/** [server] Net cull distance scale while walking. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication|Relevancy", meta = (ClampMin = "0", UIMin = "0", editcondition = "bUseExtNetRelevancy"), AdvancedDisplay)
+	float WalkRelevancyScale;
+
+	/** [server] Net cull distance scale while sprinting. Sprinting characters are heard from farther away. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication|Relevancy", meta = (ClampMin = "0", UIMin = "0", editcondition = "bUseExtNetRelevancy"), AdvancedDisplay)
+	float SprintRelevancyScale;
+
+	/** [server] Additional net cull distance scale while crouched. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication|Relevancy", meta = (ClampMin = "0", UIMin = "0", editcondition = "bUseExtNetRelevancy"), AdvancedDisplay)
+	float CrouchRelevancyScale;
+
+	/** [server] Net cull distance scale while ragdoll, replacing the gait and crouch scales. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication|Relevancy", meta = (ClampMin = "0", UIMin = "0", editcondition = "bUseExtNetRelevancy"), AdvancedDisplay)
+	float RagdollRelevancyScale;
+
+	/** [server] Minimum net cull distance scale while the character targets the viewer or looks within LookAtRelevancyAngle of it. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication|Relevancy", meta = (ClampMin = "0", UIMin = "0", editcondition = "bUseExtNetRelevancy"), AdvancedDisplay)
+	float LookAtRelevancyScale;
+
+	/** [server] Half angle in degrees of the cone around the look rotation in which a viewer counts as looked at. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication|Relevancy", meta = (ClampMin = "0", UIMin = "0", ClampMax = "180", UIMax = "180", editcondition = "bUseExtNetRelevancy"), AdvancedDisplay)
+	float LookAtRelevancyAngle;
+
+	/**
+	 * [server] Net cull distance scale applied on top of the others when the viewer has no line of sight to the character. Not applied while
+	 * the character can be heard. Use 1 to skip the line of sight test.
+	 * @see IsAudibleForNetRelevancy()
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication|Relevancy", meta = (ClampMin = "0", UIMin = "0", ClampMax = "1", UIMax = "1", editcondition = "bUseExtNetRelevancy"), AdvancedDisplay)
+	float OccludedRelevancyScale;
+
+	/** [server] Time in seconds a line of sight result is reused for the same viewer. */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Replication|Relevancy", meta = (ClampMin = "0", UIMin = "0", editcondition = "bUseExtNetRelevancy"), AdvancedDisplay)
+	float RelevancyVisibilityInterval;
+
 	/**
 	 * Amount of time needed for the character to get up from ragdoll. Tipically this should match the length of the get up animation used.
 	 * @see OnGettingUpComplete()
@@ -457,6 +671,25 @@ public: // Dynamic Multicast Delegates
 	UPROPERTY(BlueprintAssignable, Category = Character)
 	FHitReactSignature HitReactDelegate;
 
+public: // Native Multicast Delegates
+
+	/**
+	 * Native counterparts of the dynamic delegates. Always broadcast before the corresponding dynamic delegate.
+	 * Prefer these for C++ listeners as they avoid the reflection and UFunction call overhead.
+	 */
+
+	FCrouchChangedNativeSignature CrouchChangedNativeDelegate;
+
+	FGenericActionChangedNativeSignature GenericActionChangedNativeDelegate;
+
+	FGaitChangedNativeSignature GaitChangedNativeDelegate;
+
+	FRotationModeChangedNativeSignature RotationModeChangedNativeDelegate;
+
+	FRagdollChangedNativeSignature RagdollChangedNativeDelegate;
+
+	FHitReactNativeSignature HitReactNativeDelegate;
+
 private:	// Methods
 
 	/**
@@ -498,14 +731,31 @@ protected:	// Methods
 	UFUNCTION()
 	virtual void OnRep_ReplicatedExtMovementMode();
 
+	/** Handle packed state replicated from server. Only the handlers of the values that changed are called. */
+	UFUNCTION()
+	virtual void OnRep_ReplicatedExtState();
+
+	/** Pack the given movement mode byte and the current rotation mode and gait flags in the layout of ReplicatedExtState. */
+	uint16 PackReplicatedExtState(uint8 MovementModeAndJump) const;
+
 	/** Handle Extended Movement replicated from server */
 	UFUNCTION()
 	virtual void OnRep_ReplicatedExtMovement();
 
+	/** [simulated] Apply ReplicatedExtMovement to the movement component without a round-trip through ReplicatedMovement. */
+	virtual void ApplyReplicatedExtMovement();
+
 	/** Handle Look replicated from server */
 	UFUNCTION()
 	virtual void OnRep_ReplicatedLook();
 
+	/** Handle look at target replicated from server */
+	UFUNCTION()
+	virtual void OnRep_ReplicatedLookAt();
+
+	/** [server] Update ReplicatedLookAt from ReplicatedLookAtActor, limiting the rate of location only changes. */
+	virtual void UpdateReplicatedLookAt();
+
 	/** Handle Walking replicated from server */
 	UFUNCTION()
 	virtual void OnRep_IsWalkingInsteadOfRunning();
@@ -689,6 +939,16 @@ public:		// Methods
 	virtual bool GatherExtMovement();
 	virtual void PreNetReceive() override;
 	virtual void PostNetReceive() override;
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+
+	/** [server] Scale of NetCullDistanceSquared for a viewer from gait, crouch, ragdoll and look at state, before the line of sight test. */
+	virtual float GetNetRelevancyDistanceScale(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const;
+
+	/** [server] Line of sight from SrcLocation to the character, cached per viewer for RelevancyVisibilityInterval. */
+	bool IsVisibleForNetRelevancy(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const;
+
+	/** [server] True if the character makes noise that gives it away without line of sight, i.e. running or sprinting while not crouched. */
+	virtual bool IsAudibleForNetRelevancy() const;
 
 #if WITH_EDITOR
 	virtual bool CanEditChange(const FProperty* InProperty) const override;
@@ -714,6 +974,15 @@ public:		// Methods
 
 	// virtual FVector GetAcceleration() const;
 
+	/** [local] Called from Character Movement Component before the move is saved and performed. Applies the final state of the crouch, walk, sprint and generic action intents received since the last call. */
+	virtual void ApplyInputIntents();
+
+	/** [server] Copy the look rotation to ReplicatedLook if it moved past the dead band and the rate limit allows it. */
+	virtual void UpdateReplicatedLook();
+
+	/** [simulated] Advance the look rotation towards the last replicated one extrapolated by its angular velocity. */
+	virtual void UpdateProxyLook(float DeltaSeconds);
+
 	/** [server + local] Called from Character Movement Component before an update. */
 	virtual void OnUpdateBeforeMovement(float DeltaSeconds);
 
@@ -868,7 +1137,7 @@ public:		// Methods
 	UExtCharacterMovementComponent* K2_GetExtCharacterMovement() const { return (UExtCharacterMovementComponent*)(GetCharacterMovement()); }
 
 	/** @return	Look rotation of the character. */
-	FORCEINLINE FRotator GetLookRotation() const { return ReplicatedLook.Rotation; }
+	FORCEINLINE FRotator GetLookRotation() const { return CurrentLookRotation; }
 
 	/** @return	Look rotation of the character. */
 	UFUNCTION(BlueprintCallable, BlueprintPure, meta = (DisplayName="LookRotation"))
@@ -881,6 +1150,13 @@ public:		// Methods
 	/** @return	Actor this character should be looking at. */
 	FORCEINLINE AActor* GetLookAtActor() const { return ReplicatedLookAtActor; }
 
+	/**
+	 * Get the location this character should be looking at. On simulated proxies this may be a replicated location
+	 * when the look at actor is not relevant to the local client.
+	 * @return	False if there is nothing to look at.
+	 */
+	bool GetLookAtLocation(FVector& OutLocation) const;
+
 	/** */
 	FORCEINLINE bool IsRagdoll() const { return bIsRagdoll; }
 
@@ -906,6 +1182,9 @@ public:		// Methods
 	UFUNCTION(BlueprintCallable, Category = "Pawn|Character")
 	void SetRotationMode(ECharacterRotationMode Value);
 
+	/** [local] Player input received this frame. Prefer this to querying the input component by axis name. */
+	FORCEINLINE const FExtCharacterInputState& GetInputState() const { return InputState; }
+
 	/** */
 	FORCEINLINE FName GetPelvisBoneName() const { return PelvisBoneName; }
 
@@ -71,6 +71,37 @@ struct FMovementPropertiesEx
 	uint32 bCanPerformGenericAction : 1;
 };
 
+/** Move response that also carries the ext movement state of the server when the move is corrected, for client correction diagnostics. */
+struct TPCA_API FExtCharacterMoveResponseDataContainer : public FCharacterMoveResponseDataContainer
+{
+	typedef FCharacterMoveResponseDataContainer Super;
+
+	bool bHasExtState;
+	bool bIsPivotTurning;
+	ECharacterGait Gait;
+	ECharacterRotationMode RotationMode;
+	float TurnInPlaceTargetYaw;
+
+	FExtCharacterMoveResponseDataContainer();
+
+	virtual void ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+};
+
+/** Move received from a client and queued for processing on the server. */
+struct FExtQueuedServerMove
+{
+	FCharacterNetworkMoveData MoveData;
+
+	/** MoveData.MovementBase is not referenced and may be destroyed before the move is processed. */
+	TWeakObjectPtr<UPrimitiveComponent> MovementBase;
+
+	FExtQueuedServerMove(const FCharacterNetworkMoveData& InMoveData)
+		: MoveData(InMoveData)
+		, MovementBase(InMoveData.MovementBase)
+	{
+	}
+};
 
 /**
  * Extended Character Movement component that supports 3 extra movement actions replicated as compressed flags:
@@ -123,6 +154,15 @@ protected:  // Bitfields
 	 */
 	uint32 bCanEnforceTurnInPlaceRotationMaxDistance : 1;
 
+	/**
+	 * [server] True if the look angle is close to the turn in place threshold or the current turn in place target started close to a step
+	 * boundary, so the target must be sent to simulated proxies.
+	 */
+	uint32 bTurnInPlaceStepAmbiguous : 1;
+
+	/** [simulated] True while the server leaves turn in place to the proxy prediction. */
+	uint32 bProxyPredictingTurnInPlace : 1;
+
 	/**
 	 * If true Control Rotation Max Distance can be enfored.
 	 * Internally used to prevent snapping when the character comes from a different rotation mode or from ragdoll
@@ -214,6 +254,57 @@ public: // Bitfields
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement: TurnInPlace", meta = (editcondition = "bEnableTurnInPlace"))
 	uint32 bUseTurnInPlaceDelay : 1;
 
+	/**
+	 * If true simulated proxies derive turn in place from the replicated look rotation with the same rules as PhysicsRotation, and the
+	 * server only sends the turn in place target when the proxy could pick a different one.
+	 * @see ProxyTurnInPlaceStepMargin
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement: TurnInPlace", meta = (editcondition = "bEnableTurnInPlace"), AdvancedDisplay)
+	uint32 bPredictProxyTurnInPlace : 1;
+
+	/**
+	 * If true simulated proxies lower their network smoothing mode with distance to the local view and significance. NetworkSmoothingMode
+	 * is the highest mode used, then Linear beyond SmoothingLODLinearDistance and Disabled beyond SmoothingLODDisabledDistance or when not rendered.
+	 * @see SetSmoothingSignificance()
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (Networking)", AdvancedDisplay)
+	uint32 bEnableSmoothingLOD : 1;
+
+	/** If true simulated proxies do not simulate movement while at rest on a static base and converged to the last replicated position. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (Networking)", AdvancedDisplay)
+	uint32 bSkipSimulationAtRest : 1;
+
+	/**
+	 * [server] If true moves received from the owning client are queued and processed by the UServerMoveQueueSubsystem within its
+	 * per-frame budget instead of as they arrive. Only applies to packed move RPCs.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (Networking)", AdvancedDisplay)
+	uint32 bQueueServerMoves : 1;
+
+	/**
+	 * [server] If true consecutive queued moves with the same input, flags, mode and base are processed as a single longer move while
+	 * the character is at rest on the ground. Moves the client kept apart with bForceNoCombine can't be told apart and may still be combined.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (Networking)", meta = (editcondition = "bQueueServerMoves"), AdvancedDisplay)
+	uint32 bCombineQueuedServerMoves : 1;
+
+	/**
+	 * If true the server sends a flag instead of the acceleration when it points along the replicated velocity or there is none, and
+	 * simulated proxies derive it from the velocity in the same update. The acceleration is sent when neither is within DerivedAccelerationMaxError.
+	 * @see DeriveAcceleration()
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (Networking)", AdvancedDisplay)
+	uint32 bDeriveProxyAcceleration : 1;
+
+	/**
+	 * If true the server sends its ext movement state with every correction and the client records the position error, the ext state
+	 * that differed and the number of moves replayed. Results are available as stats, CSV stats and histograms, which can be logged
+	 * with the p.ExtCharacter.DumpCorrectionDiagnostics console command.
+	 * @see DumpCorrectionDiagnostics()
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (Networking)", AdvancedDisplay)
+	uint32 bRecordCorrectionDiagnostics : 1;
+
 private: // Variables
 
 #if WITH_EDITORONLY_DATA
@@ -278,6 +369,27 @@ protected:  // Variables
 	UPROPERTY()
 	FVector PushAwayAccumulatedForce;
 
+	/** Smoothing mode set on NetworkSmoothingMode on BeginPlay, the highest level picked by the smoothing LOD. */
+	ENetworkSmoothingMode MaxNetworkSmoothingMode;
+
+	/** Smoothing mode picked by the last smoothing LOD update. It is applied once the current smoothing has converged. */
+	ENetworkSmoothingMode PendingNetworkSmoothingMode;
+
+	/** Time left until the next smoothing LOD update. */
+	float SmoothingLODTimeCounter;
+
+	/** Scales distance to the local view when picking the smoothing LOD. */
+	float SmoothingSignificance;
+
+	/** [server] Moves received from the owning client waiting to be processed, oldest first. */
+	TArray<FExtQueuedServerMove> QueuedServerMoves;
+
+	/** Move response used in place of the default one. */
+	FExtCharacterMoveResponseDataContainer ExtMoveResponseDataContainer;
+
+	/** [local] Ext state of the server from the correction being handled, if it was sent. */
+	const FExtCharacterMoveResponseDataContainer* CorrectionResponse;
+
 public: // Variables
 
 	/**
@@ -347,6 +459,14 @@ public: // Variables
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement: TurnInPlace", meta = (editcondition = "bEnableTurnInPlace && !bUseTurnInPlaceDelay", ClampMin = "0", UIMin = "0", ClampMax = "180", UIMax = "180"))
 	float TurnInPlaceMaxDistance;
 
+	/**
+	 * [server] The turn in place target is sent to simulated proxies while the look angle is within this many degrees of LookAngleThreshold
+	 * or a turn started within this many degrees of a 90 degree step boundary, since their slightly different view of the rotation could
+	 * make them start a turn the server does not or pick the neighbouring step.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement: TurnInPlace", meta = (editcondition = "bPredictProxyTurnInPlace", ClampMin = "0", UIMin = "0", ClampMax = "45", UIMax = "45"), AdvancedDisplay)
+	float ProxyTurnInPlaceStepMargin;
+
 	/** Input acceleration scale. Can be used to increase/decrease the character's ability to change direction without having to modify ground/fluid friction values.	  */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (General Settings)", meta = (ClampMin = "0", UIMin = "0"))
 	float InputAccelerationScale;
@@ -471,6 +591,26 @@ public: // Variables
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, AdvancedDisplay, Category = "Character Movement: Pawn Interaction", meta = (ClampMin = "0", UIMin = "0", ClampMax = "1", UIMax = "1"))
 	float PushAwayRealVelocityFraction;
 
+	/** Simulated proxies farther than this from the local view use linear smoothing when bEnableSmoothingLOD is true. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (Networking)", meta = (ClampMin = "0", UIMin = "0", editcondition = "bEnableSmoothingLOD"), AdvancedDisplay)
+	float SmoothingLODLinearDistance;
+
+	/** Simulated proxies farther than this from the local view are not smoothed when bEnableSmoothingLOD is true. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (Networking)", meta = (ClampMin = "0", UIMin = "0", editcondition = "bEnableSmoothingLOD"), AdvancedDisplay)
+	float SmoothingLODDisabledDistance;
+
+	/** Time in seconds between smoothing LOD updates. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (Networking)", meta = (ClampMin = "0", UIMin = "0", editcondition = "bEnableSmoothingLOD"), AdvancedDisplay)
+	float SmoothingLODUpdateInterval;
+
+	/** [server] Maximum distance between the derived and the actual acceleration direction before the acceleration is sent. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (Networking)", meta = (ClampMin = "0", UIMin = "0", ClampMax = "2", UIMax = "2", editcondition = "bDeriveProxyAcceleration"), AdvancedDisplay)
+	float DerivedAccelerationMaxError;
+
+	/** Replicated horizontal speeds up to this many cm/s derive no acceleration. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Character Movement (Networking)", meta = (ClampMin = "0", UIMin = "0", editcondition = "bDeriveProxyAcceleration"), AdvancedDisplay)
+	float DerivedAccelerationVelocityTolerance;
+
 protected: // Methods
 
 	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
@@ -479,10 +619,36 @@ protected: // Methods
 	virtual void PhysWalking(float deltaTime, int32 Iterations) override;
 	virtual void ApplyVelocityBraking(float DeltaTime, float Friction, float BrakingDeceleration) override;
 	virtual void ApplyAccumulatedForces(float DeltaSeconds) override;
+	virtual void SimulatedTick(float DeltaSeconds) override;
 	virtual void SimulateMovement(float DeltaSeconds) override;
 	virtual void PerformMovement(float DeltaSeconds) override;
 	virtual FVector CalcPushAwayVelocity(float DeltaTime);
 
+	/** [simulated] Pick the smoothing mode for the distance to the local view and apply it once the current smoothing has converged. */
+	virtual void UpdateSmoothingLOD(float DeltaSeconds);
+
+	/** [simulated] @return the smoothing mode for the current distance to the local view, visibility and significance. */
+	virtual ENetworkSmoothingMode ComputeSmoothingLOD() const;
+
+	/** [simulated] @return true if the proxy is standing still on a static base with no pending smoothing, forces or root motion. */
+	virtual bool IsProxyAtRest() const;
+
+	virtual void ServerMove_HandleMoveData(const FCharacterNetworkMoveDataContainer& MoveDataContainer) override;
+	virtual void ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) override;
+	virtual void OnClientCorrectionReceived(FNetworkPredictionData_Client_Character& ClientData, float TimeStamp, FVector NewLocation, FVector NewVelocity, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode) override;
+
+	/** [local] Record a correction received for the last acked move in the correction diagnostics. */
+	virtual void RecordClientCorrection(const FNetworkPredictionData_Client_Character& ClientData, const FVector& NewLocation);
+
+	/** [server] Add a move to the queue. */
+	virtual void EnqueueServerMove(const FCharacterNetworkMoveData& MoveData);
+
+	/**
+	 * [server] @return true if NewMove can replace the queued Move about to be processed and be processed as one move spanning both.
+	 * Rejects every move pair the server can tell the client would have kept apart. PrevTimeStamp is the time stamp of the move processed before Move.
+	 */
+	virtual bool CanCombineQueuedServerMoves(const FCharacterNetworkMoveData& Move, const FCharacterNetworkMoveData& NewMove, float PrevTimeStamp) const;
+
 	virtual void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity);
 
 	/** Called after MovementMode has changed. It does special handling for starting certain modes then calls OnAfterMovementModeChanged and notifies the CharacterOwner. */
@@ -509,10 +675,51 @@ public: // Methods
 
 	virtual FVector GetSimulatedAcceleration() const;
 
+	/**
+	 * Set the significance used by the smoothing LOD, e.g. from a significance manager. The distance to the local view is divided by it
+	 * so values above one keep higher quality smoothing farther away. Default is one.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|CharacterMovement")
+	void SetSmoothingSignificance(float Value);
+
+	FORCEINLINE float GetSmoothingSignificance() const { return SmoothingSignificance; }
+
+	/** [server] Process the oldest queued move from the owning client. @return false if there was none. */
+	bool ProcessQueuedServerMove();
+
+	/** [server] Number of moves from the owning client waiting to be processed. */
+	FORCEINLINE int32 GetNumQueuedServerMoves() const { return QueuedServerMoves.Num(); }
+
+	/** Log the client correction histograms and counters recorded by every character with bRecordCorrectionDiagnostics. */
+	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|CharacterMovement")
+	static void DumpCorrectionDiagnostics();
+
+	/** Clear the client correction histograms and counters. */
+	UFUNCTION(BlueprintCallable, Category = "Pawn|Components|CharacterMovement")
+	static void ResetCorrectionDiagnostics();
+
+	/** Number of client corrections and replayed moves recorded by the correction diagnostics since the last reset. */
+	static void GetCorrectionDiagnosticsTotals(int32& OutNumCorrections, int32& OutNumMovesReplayed);
+
+	/** Cycles spent in SimulatedTick by every simulated proxy since start. */
+	static uint64 GetProxySimulationCycles();
+
 	virtual void SetReplicatedAcceleration(const FVector& Value);
+
+	/**
+	 * Acceleration direction derived from a replicated velocity alone: along its horizontal direction if bAlongVelocity is true, otherwise
+	 * none as when braking. Velocities slower than DerivedAccelerationVelocityTolerance derive no acceleration.
+	 */
+	FVector DeriveAcceleration(const FVector& ReplicatedVelocity, bool bAlongVelocity) const;
 	virtual void SetReplicatedPivotTurn(bool bInIsPivotTurning);
 	virtual void SetReplicatedTurnInPlace(float InTurnInPlaceTargetYaw);
 
+	/** [simulated] The server did not send a turn in place target, keep predicting it locally. */
+	virtual void SetPredictedTurnInPlace();
+
+	/** [server] True if simulated proxies can predict the current turn in place target on their own. */
+	bool CanProxyPredictTurnInPlace() const;
+
 	virtual FRotator GetDeltaRotation(float DeltaSeconds) const final;
 	virtual FRotator ComputeOrientToMovementRotation(const FRotator& CurrentRotation, float DeltaSeconds, FRotator& DeltaRotation) const final;
 
@@ -539,9 +746,26 @@ public: // Methods
 	 */
 	virtual bool CanTurnInPlaceInCurrentState() const;
 
+	/**
+	 * Rules under which turn in place is suspended, shared by PhysicsRotation and PredictProxyTurnInPlace so that proxies agree with the server.
+	 * @param	bHasDesiredRotation	Whether there is a desired rotation to follow, i.e. a controller or a replicated look rotation.
+	 * @param	bOutKeepTarget			Set to true if the current target must be kept as is (ragdoll or getting up) instead of being suspended.
+	 * @return true if turn in place can be updated.
+	 */
+	bool CanUpdateTurnInPlace(bool bHasDesiredRotation, bool& bOutKeepTarget) const;
+
 	virtual void ResetTurnInPlaceState();
 	virtual void ResetControllerDesireRotationState();
 
+	/** Angle in multiples of 90 degrees to turn in place for a look yaw delta beyond LookAngleThreshold. False if within the threshold. */
+	bool GetTurnInPlaceAngle(float LookYawDelta, float& OutTurnInPlaceAngle) const;
+
+	/** True if a look yaw delta is within ProxyTurnInPlaceStepMargin of starting a turn or changing the number of 90 degree steps to turn. */
+	bool IsTurnInPlaceStepAmbiguous(float LookYawDelta) const;
+
+	/** [simulated] Update TurnInPlaceTargetYaw from the look rotation and current rotation the way PhysicsRotation does on the server. */
+	virtual void PredictProxyTurnInPlace(float DeltaSeconds);
+
 	virtual bool CanCrouchInCurrentState() const override;
 	virtual bool CanWalkOffLedges() const override;
 
@@ -675,6 +899,12 @@ public:
 	bool bWantsToSprint;
 	bool bWantsToPerformGenericAction;
 
+	/** Ext state after the move, compared against the server state when the move is corrected. */
+	bool bSavedIsPivotTurning;
+	ECharacterGait SavedGait;
+	ECharacterRotationMode SavedRotationMode;
+	float SavedTurnInPlaceTargetYaw;
+
 public:
 
 	virtual void Clear() override;
@@ -682,6 +912,7 @@ public:
 	// virtual bool IsImportantMove(const FSavedMovePtr& LastAckedMove) const override;
 	// virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* Character, float MaxDelta) const override;
 	virtual void PrepMoveFor(ACharacter* Character) override;
+	virtual void PostUpdate(ACharacter* Character, EPostUpdateMode PostUpdateMode) override;
 	virtual uint8 GetCompressedFlags() const override;
 };
 
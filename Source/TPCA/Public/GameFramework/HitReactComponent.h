@@ -0,0 +1,74 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Components/ActorComponent.h"
+#include "TPCATypes.h"
+
+#include "HitReactComponent.generated.h"
+
+class AExtCharacter;
+class UAnimInstance;
+class UAnimMontage;
+
+/**
+ * Plays hit reaction montages natively in response to AExtCharacter::MulticastPlayHitReact.
+ * Montages are resolved per direction once on BeginPlay. A reaction that is still playing is rewound instead of starting a new montage
+ * instance, and hits received within CoalesceWindow of the last reaction are merged into it.
+ */
+UCLASS(ClassGroup = Character, meta = (BlueprintSpawnableComponent))
+class TPCA_API UHitReactComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UHitReactComponent();
+
+	/** Montage played for a hit from each direction. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hit React")
+	TMap<ECardinalDirection, UAnimMontage*> Montages;
+
+	/** Montage played for directions without an entry in Montages. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hit React")
+	UAnimMontage* DefaultMontage;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hit React")
+	float PlayRate;
+
+	/** Hits received within this time of the last reaction do not start a new one. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hit React", meta = (ClampMin = "0", UIMin = "0"))
+	float CoalesceWindow;
+
+	//~Begin UActorComponent
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	//~End UActorComponent
+
+	/** Play the reaction for a hit from the given direction, unless it is coalesced with the previous one. */
+	UFUNCTION(BlueprintCallable, Category = "Hit React")
+	void PlayHitReact(ECardinalDirection HitDirection);
+
+	/** Rebuild the direction to montage table after changing Montages or DefaultMontage at runtime. */
+	UFUNCTION(BlueprintCallable, Category = "Hit React")
+	void RebuildMontageTable();
+
+	/** Number of hits merged into an earlier reaction since BeginPlay. */
+	FORCEINLINE int32 GetNumCoalescedHits() const { return NumCoalescedHits; }
+
+private:
+
+	static const int32 NumDirections = 4;
+
+	/** Montage for each direction, indexed by ECardinalDirection. */
+	UPROPERTY(Transient)
+	UAnimMontage* MontageTable[NumDirections];
+
+	float LastReactTime;
+	int32 NumCoalescedHits;
+
+	void HandleHitReact(AExtCharacter* Sender, ECardinalDirection HitDirection, AActor* DamageCauser);
+	UAnimInstance* GetAnimInstance() const;
+};
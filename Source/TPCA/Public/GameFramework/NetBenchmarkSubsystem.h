@@ -0,0 +1,89 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Math/RandomStream.h"
+
+#include "NetBenchmarkSubsystem.generated.h"
+
+class AExtCharacter;
+class APlayerController;
+
+/**
+ * Measures the network cost of ExtCharacters in a process started with -NetBenchmark, normally by the NetBenchmark commandlet.
+ * Servers sample frame CPU time and bandwidth per connection. Clients drive their character with scripted input and sample corrections,
+ * proxy simulation cost and bandwidth. Sampling starts after -BenchmarkWarmup seconds and lasts -BenchmarkDuration seconds, then the
+ * results are written to -BenchmarkReport as Key,Value lines and the process exits.
+ */
+UCLASS()
+class TPCA_API UNetBenchmarkSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UNetBenchmarkSubsystem();
+
+	//~Begin USubsystem
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem
+
+protected:
+
+	//~Begin USubsystem
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	//~End USubsystem
+
+private:
+
+	float WarmupTime;
+	float Duration;
+	FString ReportPath;
+	FRandomStream RandomStream;
+
+	/** World time sampling started at, negative until then. */
+	float StartTime;
+	bool bIsFinished;
+
+	/** Frames and seconds sampled. */
+	int32 NumFrames;
+	double CpuSeconds;
+
+	/** Once per second samples of connection bandwidth. */
+	float NextBandwidthSampleTime;
+	int32 NumBandwidthSamples;
+	double InBytesPerSecond;
+	double OutBytesPerSecond;
+	double NumConnectionSamples;
+
+	/** Client counters at the start of sampling. */
+	uint64 StartProxySimulationCycles;
+	int32 StartNumCorrections;
+	int32 StartNumMovesReplayed;
+	int64 NumProxyFrames;
+
+	/** Scripted input state. */
+	float CirclePhase;
+	float NextActionTime;
+	float StopJumpingTime;
+	float ResumeMovingTime;
+
+	FDelegateHandle PreActorTickHandle;
+	FDelegateHandle ActorSpawnedHandle;
+
+	void HandlePreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+	void HandleActorSpawned(AActor* Actor);
+	void StartSampling();
+
+	/** Make the character record client corrections, or send its ext state with them on the server. */
+	void RecordCorrectionDiagnostics(AExtCharacter* Character);
+	void SampleFrame();
+	void SampleBandwidth();
+	void DriveCharacter(AExtCharacter* Character, APlayerController* PlayerController, float Time);
+	void Finish();
+};
@@ -0,0 +1,67 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+
+#include "ServerMoveQueueSubsystem.generated.h"
+
+class UExtCharacterMovementComponent;
+
+/**
+ * Processes the server moves queued by every UExtCharacterMovementComponent in a world once per frame, before actors tick.
+ * Each character with queued moves processes one move per frame, the rest are shared round robin across characters until
+ * MaxProcessingTimeMs is spent and deferred to the next frame, so a few bursty clients cannot starve the frame.
+ */
+UCLASS(Config = Game)
+class TPCA_API UServerMoveQueueSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	UServerMoveQueueSubsystem();
+
+	/** Time in milliseconds spent per frame on moves beyond the first one of each character. */
+	UPROPERTY(Config)
+	float MaxProcessingTimeMs;
+
+	/** Moves queued per character beyond this are processed as they arrive. */
+	UPROPERTY(Config)
+	int32 MaxQueuedMovesPerCharacter;
+
+	//~Begin USubsystem
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	//~End USubsystem
+
+	/** Schedule the queued moves of a movement component for processing. */
+	void RegisterMoveQueue(UExtCharacterMovementComponent* MovementComponent);
+
+	/** Moves left in the queues after the last update. */
+	FORCEINLINE int32 GetNumDeferredMoves() const { return NumDeferredMoves; }
+
+protected:
+
+	//~Begin USubsystem
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	//~End USubsystem
+
+private:
+
+	/** Movement components with queued moves in round robin order. */
+	TArray<TWeakObjectPtr<UExtCharacterMovementComponent>> MoveQueues;
+
+	/** Queue served first on the next update. Rotates every frame so no character is always served last. */
+	int32 NextQueueIndex;
+
+	int32 NumDeferredMoves;
+
+	FDelegateHandle PreActorTickHandle;
+
+	void HandlePreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+	void ProcessMoveQueues();
+};
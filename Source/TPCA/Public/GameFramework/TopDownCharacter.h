@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
 #include "GameFramework/ExtCharacter.h"
 #include "Interfaces/PawnControlInterface.h"
 
@@ -10,6 +11,68 @@
 
 class UArmComponent;
 class APlayerController;
+class ATopDownCharacter;
+
+/**
+ * Tick function that runs before the character movement. Used for late update aiming so the control rotation is applied in the same frame.
+ */
+USTRUCT()
+struct FTopDownCharacterPreMovementTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Character that is the target of this tick. */
+	ATopDownCharacter* Target;
+
+	FTopDownCharacterPreMovementTickFunction()
+		: Target(nullptr)
+	{}
+
+	//~Begin FTickFunction
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	//~End FTickFunction
+};
+
+template<>
+struct TStructOpsTypeTraits<FTopDownCharacterPreMovementTickFunction> : public TStructOpsTypeTraitsBase2<FTopDownCharacterPreMovementTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Tick function that runs after movement and the camera bracket have been updated for the frame. Used for camera critical path and cursor
+ * latency measurements.
+ */
+USTRUCT()
+struct FTopDownCharacterLateUpdateTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Character that is the target of this tick. */
+	ATopDownCharacter* Target;
+
+	FTopDownCharacterLateUpdateTickFunction()
+		: Target(nullptr)
+	{}
+
+	//~Begin FTickFunction
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	//~End FTickFunction
+};
+
+template<>
+struct TStructOpsTypeTraits<FTopDownCharacterLateUpdateTickFunction> : public TStructOpsTypeTraitsBase2<FTopDownCharacterLateUpdateTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
 
 /**
  * Basic character implementation for top-down games where the generic action is to aim using a laser pointer.
@@ -47,6 +110,85 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	UArmComponent* CameraBracket;
 
+	/**
+	 * Tick group of the camera bracket. Using a later group than the character (e.g. PostUpdateWork) takes the bracket out of the
+	 * character's tick chain so other work can overlap with the character tick.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = Camera, AdvancedDisplay)
+	TEnumAsByte<ETickingGroup> CameraBracketTickGroup;
+
+	/** If true the camera bracket waits for the character movement to tick so that it follows the location of the current frame. */
+	UPROPERTY(EditDefaultsOnly, Category = Camera, AdvancedDisplay)
+	bool bCameraBracketTickAfterMovement;
+
+	/** Cycles at the start of the pre movement tick. Used to measure the critical path up to the camera bracket. */
+	uint64 CameraCriticalPathStartCycles;
+
+	/**
+	 * Late update tick. Runs in TG_PostUpdateWork after the camera bracket, when movement has already been applied for the frame so the
+	 * character's facing is the one that will be rendered.
+	 */
+	UPROPERTY()
+	FTopDownCharacterLateUpdateTickFunction LateUpdateTickFunction;
+
+	/**
+	 * Pre movement tick. Runs in TG_PrePhysics as a prerequisite of the character movement, which otherwise ticks before the character
+	 * itself (bTickBeforeOwner).
+	 */
+	UPROPERTY()
+	FTopDownCharacterPreMovementTickFunction PreMovementTickFunction;
+
+	/** Inverse view projection matrix built from the cached camera view. */
+	FMatrix CachedInvViewProjectionMatrix;
+
+	/** Frame in which CachedInvViewProjectionMatrix was built. */
+	uint64 CachedViewFrame;
+
+	/** Cursor position used for the last aim sample. */
+	FVector2D LastCursorPosition;
+
+	/** Synthetic cursor position used instead of the mouse when bUseSyntheticCursor is true. */
+	FVector2D SyntheticCursorPosition;
+
+	/** Viewport size used with the synthetic cursor when there is no viewport (e.g. headless). */
+	FIntPoint SyntheticViewportSize;
+
+	/** Yaw the character is expected to face for the pending latency measurement. */
+	float PendingAimYaw;
+
+	/** Time at which the cursor moved for the pending latency measurement. */
+	double PendingAimStartTime;
+
+	/** Frame at which the cursor moved for the pending latency measurement. */
+	uint64 PendingAimStartFrame;
+
+	/** Last measured time between a cursor movement and the character facing the cursor in a rendered frame, in seconds. */
+	float LastCursorAimLatency;
+
+	/** Last measured number of frames between a cursor movement and the character facing the cursor in a rendered frame. */
+	int32 LastCursorAimLatencyFrames;
+
+	uint32 bHasPendingAim : 1;
+	uint32 bUseSyntheticCursor : 1;
+
+	/** Deproject a screen position using the view cached by the camera manager, i.e. the view of the last rendered frame. */
+	bool DeprojectFromCachedView(APlayerController* PC, const FVector2D& ScreenPosition, const FIntPoint& ViewportSize, FVector& OutWorldLocation, FVector& OutWorldDirection);
+
+	/** Get the current cursor position and viewport size, either from the mouse or the synthetic cursor. */
+	bool GetCursorPosition(APlayerController* PC, FVector2D& OutScreenPosition, FIntPoint& OutViewportSize) const;
+
+	/** Find the direction from the character to the cursor projected on the ground plane. */
+	bool GetCursorAimDirection(const FVector& CursorLocation, const FVector& CursorDirection, FVector& OutDirection) const;
+
+	/** Record a cursor sample. Starts a latency measurement if the cursor moved. */
+	void NoteCursorSample(const FVector2D& ScreenPosition, const FVector& DesiredDirection);
+
+	/** [local] Sample the cursor and set the control rotation directly. Runs in the pre movement tick so movement applies it in the same frame. */
+	void UpdateLateUpdateAim();
+
+	/** Complete the pending latency measurement if the character is already facing the cursor. */
+	void UpdateCursorAimLatency();
+
 protected:
 
 	virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
@@ -66,7 +208,27 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Input)
 	bool bUseMouseToLook;
 
+	/**
+	 * If true, the cursor is sampled in a tick function that runs right before the character movement instead of during input processing and
+	 * the control rotation is set directly. Deprojection reuses the view cached by the camera manager for the last rendered frame, which is the
+	 * view the cursor was placed against. Camera modifiers that process view rotation are bypassed in this mode.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Input)
+	bool bUseLateUpdateAim;
+
+	/** Maximum angle between the control rotation and the cursor direction for the character to be considered facing the cursor. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Input, AdvancedDisplay, meta = (ClampMin = "0", UIMin = "0"))
+	float CursorAimLatencyTolerance;
+
 	virtual void Tick(float DeltaTime) override;
+	virtual void PostInitializeComponents() override;
+	virtual void RegisterActorTickFunctions(bool bRegister) override;
+
+	/** [local] Called by the pre movement tick function before the character movement ticks. */
+	virtual void PreMovementUpdate(float DeltaTime);
+
+	/** [local] Called by the late update tick function after movement and the camera bracket have been updated for the frame. */
+	virtual void LateUpdate(float DeltaTime);
 	virtual void CalcCamera(float DeltaTime, FMinimalViewInfo& OutResult) override;
 	virtual bool HasActiveCameraComponent() const override;
 	virtual bool HasActivePawnControlCameraComponent() const override;
@@ -86,4 +248,20 @@ public:
 	/** Make the character taunt another character. */
 	UFUNCTION(BlueprintCallable, Category = Character)
 	virtual void Taunt();
+
+	/** Use a synthetic cursor instead of the mouse. Viewport size is only used when the player has no viewport. Meant for automated tests. */
+	UFUNCTION(BlueprintCallable, Category = Input)
+	void SetSyntheticCursor(FVector2D ScreenPosition, FIntPoint ViewportSize);
+
+	/** Go back to using the mouse cursor. */
+	UFUNCTION(BlueprintCallable, Category = Input)
+	void ClearSyntheticCursor();
+
+	/** Last measured time between a cursor movement and the character facing the cursor in a rendered frame, in seconds. */
+	UFUNCTION(BlueprintPure, Category = Input)
+	float GetLastCursorAimLatency() const { return LastCursorAimLatency; }
+
+	/** Last measured number of frames between a cursor movement and the character facing the cursor in a rendered frame. */
+	UFUNCTION(BlueprintPure, Category = Input)
+	int32 GetLastCursorAimLatencyFrames() const { return LastCursorAimLatencyFrames; }
 };
@@ -9,6 +9,8 @@
 
 #include "TPCATypes.generated.h"
 
+class AActor;
+
 extern TPCA_API const FName NAME_Spectator;
 extern TPCA_API const FName NAME_Normal;
 extern TPCA_API const FName NAME_Ragdoll;
@@ -51,6 +53,12 @@ bool TPCA_API SerializeQuantizedVector(FArchive& Ar, FVector& Vector, EVectorQua
 /** Helper function for net serialization of FRotator */
 void TPCA_API SerializeQuantizedRotator(FArchive& Ar, FRotator& Rotator, ERotatorQuantization QuantizationLevel);
 
+/** Round a vector to the value SerializeQuantizedVector would produce on the receiving end. */
+FVector TPCA_API QuantizeVector(const FVector& Vector, EVectorQuantization QuantizationLevel);
+
+/** Round a rotator to the value SerializeQuantizedRotator would produce on the receiving end. */
+FRotator TPCA_API QuantizeRotator(const FRotator& Rotator, ERotatorQuantization QuantizationLevel);
+
 /**
  * Replicated look rotation.
  * Struct used for configurable replication precision.
@@ -103,6 +111,56 @@ struct TStructOpsTypeTraits<FRepLook>: public TStructOpsTypeTraitsBase2<FRepLook
 	};
 };
 
+/**
+ * Replicated look at target.
+ * The actor reference is only sent to connections the actor is replicated to. Other connections receive a world space point instead,
+ * which avoids sending a GUID that the client cannot resolve and the pending reference that comes with it.
+ */
+USTRUCT()
+struct TPCA_API FRepLookAt
+{
+	GENERATED_BODY()
+
+	FRepLookAt()
+		: Actor(nullptr)
+		, Location(ForceInitToZero)
+		, bHasTarget(false)
+	{}
+
+	/** Actor to look at. Null on connections that received the location only. */
+	UPROPERTY(Transient)
+	AActor* Actor;
+
+	/** Location of the actor when it was last updated. Always sent so it can be used when the actor does not resolve. */
+	UPROPERTY(Transient)
+	FVector Location;
+
+	/** False if there is nothing to look at. */
+	UPROPERTY(Transient)
+	bool bHasTarget;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FRepLookAt& Other) const
+	{
+		return Actor == Other.Actor && Location == Other.Location && bHasTarget == Other.bHasTarget;
+	}
+
+	bool operator!=(const FRepLookAt& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+template<>
+struct TStructOpsTypeTraits<FRepLookAt>: public TStructOpsTypeTraitsBase2<FRepLookAt>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
 /**
  * Replacement for FRepMovement that replicates acceleration normal, pivot turn state and turn in place target
  */
@@ -114,6 +172,18 @@ struct TPCA_API FRepExtMovement
 	UPROPERTY(Transient)
 	uint8 bIsPivotTurning : 1;
 
+	/** If true simulated proxies predict turn in place themselves and TurnInPlaceTargetYaw is not sent. */
+	UPROPERTY(Transient)
+	uint8 bTurnInPlacePredicted : 1;
+
+	/** If true simulated proxies derive the acceleration from Velocity and bAccelerationAlongVelocity, and Acceleration is not sent. */
+	UPROPERTY(Transient)
+	uint8 bAccelerationDerived : 1;
+
+	/** If the acceleration is derived, true if it points along Velocity and false if there is none (e.g. braking). */
+	UPROPERTY(Transient)
+	uint8 bAccelerationAlongVelocity : 1;
+
 	UPROPERTY(Transient)
 	FVector Location;
 
@@ -143,6 +213,9 @@ struct TPCA_API FRepExtMovement
 
 	FRepExtMovement()
 		: bIsPivotTurning(false)
+		, bTurnInPlacePredicted(false)
+		, bAccelerationDerived(false)
+		, bAccelerationAlongVelocity(false)
 		, Location(ForceInitToZero)
 		, Rotation(ForceInitToZero)
 		, Velocity(ForceInitToZero)
@@ -156,25 +229,45 @@ struct TPCA_API FRepExtMovement
 	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
 	{
 		// Pack bitfield with flags
-		uint8 Flags = (bIsPivotTurning << 0);
-		Ar.SerializeBits(&Flags, 1);
+		uint8 Flags = (bIsPivotTurning << 0) | (bTurnInPlacePredicted << 1) | (bAccelerationDerived << 2) | (bAccelerationAlongVelocity << 3);
+		Ar.SerializeBits(&Flags, 4);
 		bIsPivotTurning = (Flags & (1 << 0)) ? 1 : 0;
+		bTurnInPlacePredicted = (Flags & (1 << 1)) ? 1 : 0;
+		bAccelerationDerived = (Flags & (1 << 2)) ? 1 : 0;
+		bAccelerationAlongVelocity = (Flags & (1 << 3)) ? 1 : 0;
 
 		bOutSuccess = true;
 
 		bOutSuccess &= SerializeQuantizedVector(Ar, Location, LocationQuantizationLevel);
 		SerializeQuantizedRotator(Ar, Rotation, RotationQuantizationLevel);
 		bOutSuccess &= SerializeQuantizedVector(Ar, Velocity, VelocityQuantizationLevel);
-		bOutSuccess &= SerializeFixedVector<1, 16>(Acceleration, Ar);
+		if (!bAccelerationDerived)
+			bOutSuccess &= SerializeFixedVector<1, 16>(Acceleration, Ar);
 
-		Ar << TurnInPlaceTargetYaw;
+		if (!bTurnInPlacePredicted)
+			Ar << TurnInPlaceTargetYaw;
 
 		return true;
 	}
 
+	/**
+	 * Round location, rotation, velocity and acceleration to the values NetSerialize produces on the receiving end, so that changes smaller
+	 * than the quantization step compare equal and do not mark the property dirty.
+	 */
+	void Quantize();
+
+	/**
+	 * True if the quantized values of Other are within the given errors of these. Flags and the turn in place target, unless predicted, must match exactly,
+	 * as must whether velocity and acceleration are zero. Rotation error is in degrees per component. Both structs are expected to be quantized already.
+	 */
+	bool IsNearlyEqual(const FRepExtMovement& Other, float LocationError, float RotationError, float VelocityError, float AccelerationError) const;
+
 	bool operator==(const FRepExtMovement& Other) const
 	{
 		return bIsPivotTurning == Other.bIsPivotTurning
+			&& bTurnInPlacePredicted == Other.bTurnInPlacePredicted
+			&& bAccelerationDerived == Other.bAccelerationDerived
+			&& bAccelerationAlongVelocity == Other.bAccelerationAlongVelocity
 			&& Location == Other.Location
 			&& Rotation == Other.Rotation
 			&& Velocity == Other.Velocity
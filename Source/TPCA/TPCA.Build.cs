@@ -23,6 +23,7 @@ public TPCA(ReadOnlyTargetRules Target) : base(Target)
 				"CoreUObject",
 				"Engine",
 				"AnimationCore",
+				"PhysicsCore",
 				"InputCore",
 				"AIModule",
                 "GameplayTasks",
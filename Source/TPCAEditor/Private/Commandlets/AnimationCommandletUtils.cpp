@@ -0,0 +1,81 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "Commandlets/AnimationCommandletUtils.h"
+#include "TPCAEditor.h"
+#include "Animation/AnimSequence.h"
+#include "AssetRegistryModule.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/PackageName.h"
+#include "Misc/SecureHash.h"
+#include "UObject/Package.h"
+
+namespace AnimationCommandletUtils
+{
+	void GatherAnimSequences(const TArray<FString>& PackagePaths, TArray<FAssetData>& OutAssets)
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+		AssetRegistry.SearchAllAssets(true);
+
+		FARFilter Filter;
+		Filter.ClassNames.Add(UAnimSequence::StaticClass()->GetFName());
+		Filter.bRecursiveClasses = true;
+		Filter.bRecursivePaths = true;
+		for (const FString& PackagePath : PackagePaths)
+			Filter.PackagePaths.Add(FName(*PackagePath));
+
+		AssetRegistry.GetAssets(Filter, OutAssets);
+
+		// Deterministic order makes logs comparable between runs
+		OutAssets.Sort([](const FAssetData& A, const FAssetData& B) { return A.ObjectPath.LexicalLess(B.ObjectPath); });
+	}
+
+	void ParsePackagePaths(const TMap<FString, FString>& ParamVals, TArray<FString>& OutPackagePaths)
+	{
+		if (const FString* Paths = ParamVals.Find(TEXT("Paths")))
+		{
+			FString Normalized = Paths->Replace(TEXT(","), TEXT("+"));
+			Normalized.ParseIntoArray(OutPackagePaths, TEXT("+"), true);
+		}
+
+		if (OutPackagePaths.Num() == 0)
+			OutPackagePaths.Add(TEXT("/Game"));
+	}
+
+	bool PrepareForSampling(UAnimSequence* AnimSequence)
+	{
+		check(IsInGameThread());
+
+		if (!AnimSequence->IsCompressedDataValid())
+			AnimSequence->RequestSyncAnimRecompression(false);
+
+		return AnimSequence->IsCompressedDataValid();
+	}
+
+	FString GetSourceHash(const UAnimSequence* AnimSequence, const FString& Settings)
+	{
+		FSHA1 Sha;
+		const FString RawDataGuid = AnimSequence->GetRawDataGuid().ToString();
+		Sha.UpdateWithString(*RawDataGuid, RawDataGuid.Len());
+		Sha.UpdateWithString(*Settings, Settings.Len());
+		Sha.Final();
+
+		FSHAHash Hash;
+		Sha.GetHash(Hash.Hash);
+		return Hash.ToString();
+	}
+
+	bool SavePackage(UPackage* Package)
+	{
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+
+		if (IFileManager::Get().IsReadOnly(*Filename))
+			FPlatformFileManager::Get().GetPlatformFile().SetReadOnly(*Filename, false);
+
+		const bool bSaved = UPackage::SavePackage(Package, nullptr, RF_Standalone, *Filename, GError, nullptr, false, true, SAVE_NoError);
+		if (!bSaved)
+			UE_LOG(LogTPCAEditor, Error, TEXT("Failed to save %s"), *Filename);
+
+		return bSaved;
+	}
+}
@@ -0,0 +1,31 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetData.h"
+
+class UAnimSequence;
+class UPackage;
+
+/** Helpers shared by the animation processing commandlets. */
+namespace AnimationCommandletUtils
+{
+	/**
+	 * Find all animation sequences under the given package paths (e.g. /Game/Characters/Animations), recursively.
+	 * Waits for the asset registry to finish scanning so it can be used from a headless commandlet.
+	 */
+	void GatherAnimSequences(const TArray<FString>& PackagePaths, TArray<FAssetData>& OutAssets);
+
+	/** Parse a list of package paths separated by '+' or ',' from a commandlet parameter. Defaults to /Game. */
+	void ParsePackagePaths(const TMap<FString, FString>& ParamVals, TArray<FString>& OutPackagePaths);
+
+	/** Make sure the animation has valid compressed data so that it can be sampled from any thread. Game thread only. */
+	bool PrepareForSampling(UAnimSequence* AnimSequence);
+
+	/** Hash identifying the source animation data and any additional settings that affect the generated data. */
+	FString GetSourceHash(const UAnimSequence* AnimSequence, const FString& Settings);
+
+	/** Save a modified package to disk, clearing the read-only flag if needed. */
+	bool SavePackage(UPackage* Package);
+}
@@ -0,0 +1,146 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "Commandlets/DistanceMatchingCommandlet.h"
+#include "Commandlets/AnimationCommandletUtils.h"
+#include "TPCAEditor.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/DistanceMatchingAssetUserData.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+#include "UObject/UObjectGlobals.h"
+
+static void SampleRootMotionDistances(const UAnimSequence* AnimSequence, float TimeStep, TArray<float>& OutDistances)
+{
+	const float PlayLength = AnimSequence->SequenceLength;
+	const int32 NumSamples = FMath::CeilToInt(PlayLength / TimeStep) + 1;
+	OutDistances.SetNumUninitialized(NumSamples);
+	OutDistances[0] = 0.f;
+
+	float Distance = 0.f;
+	float PrevTime = 0.f;
+	for (int32 Index = 1; Index < NumSamples; ++Index)
+	{
+		const float Time = FMath::Min(Index * TimeStep, PlayLength);
+		Distance += AnimSequence->ExtractRootMotionFromRange(PrevTime, Time).GetTranslation().Size();
+		OutDistances[Index] = Distance;
+		PrevTime = Time;
+	}
+}
+
+UDistanceMatchingCommandlet::UDistanceMatchingCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UDistanceMatchingCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	TArray<FString> PackagePaths;
+	AnimationCommandletUtils::ParsePackagePaths(ParamVals, PackagePaths);
+
+	float SampleRate = 30.f;
+	float DistanceStep = 1.f;
+	int32 BatchSize = 256;
+	FParse::Value(*Params, TEXT("SampleRate="), SampleRate);
+	FParse::Value(*Params, TEXT("DistanceStep="), DistanceStep);
+	FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+	const bool bForce = Switches.Contains(TEXT("Force"));
+	const bool bNoSave = Switches.Contains(TEXT("NoSave"));
+
+	if (SampleRate <= 0.f || DistanceStep <= 0.f || BatchSize <= 0)
+	{
+		UE_LOG(LogTPCAEditor, Error, TEXT("SampleRate, DistanceStep and BatchSize must be greater than zero."));
+		return 1;
+	}
+
+	const float TimeStep = 1.f / SampleRate;
+	const FString Settings = FString::Printf(TEXT("%g;%g"), SampleRate, DistanceStep);
+
+	TArray<FAssetData> Assets;
+	AnimationCommandletUtils::GatherAnimSequences(PackagePaths, Assets);
+	UE_LOG(LogTPCAEditor, Display, TEXT("DistanceMatching: found %d animation sequences in %s"), Assets.Num(), *FString::Join(PackagePaths, TEXT(", ")));
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 NumUpdated = 0;
+	int32 NumSkipped = 0;
+	int32 NumFailed = 0;
+
+	for (int32 BatchStart = 0; BatchStart < Assets.Num(); BatchStart += BatchSize)
+	{
+		const int32 BatchEnd = FMath::Min(BatchStart + BatchSize, Assets.Num());
+
+		// Loading and compression must happen on the game thread
+		TArray<UAnimSequence*> Batch;
+		TArray<FString> Hashes;
+		for (int32 AssetIndex = BatchStart; AssetIndex < BatchEnd; ++AssetIndex)
+		{
+			UAnimSequence* AnimSequence = Cast<UAnimSequence>(Assets[AssetIndex].GetAsset());
+			if (!AnimSequence || !AnimationCommandletUtils::PrepareForSampling(AnimSequence))
+			{
+				UE_LOG(LogTPCAEditor, Warning, TEXT("DistanceMatching: could not load %s"), *Assets[AssetIndex].ObjectPath.ToString());
+				++NumFailed;
+				continue;
+			}
+
+			const FString Hash = AnimationCommandletUtils::GetSourceHash(AnimSequence, Settings);
+			const UDistanceMatchingAssetUserData* Existing = UDistanceMatchingAssetUserData::Find(AnimSequence);
+			// Data built before the last sample time was stored is rebuilt
+			if (!bForce && Existing && Existing->SourceHash == Hash && Existing->PlayLength > 0.f)
+			{
+				++NumSkipped;
+				continue;
+			}
+
+			Batch.Add(AnimSequence);
+			Hashes.Add(Hash);
+		}
+
+		TArray<TArray<float>> Distances;
+		Distances.SetNum(Batch.Num());
+		ParallelFor(Batch.Num(), [&Batch, &Distances, TimeStep](int32 Index)
+		{
+			SampleRootMotionDistances(Batch[Index], TimeStep, Distances[Index]);
+		});
+
+		for (int32 Index = 0; Index < Batch.Num(); ++Index)
+		{
+			UAnimSequence* AnimSequence = Batch[Index];
+			AnimSequence->Modify();
+
+			UDistanceMatchingAssetUserData* DistanceMatchingData = UDistanceMatchingAssetUserData::Find(AnimSequence);
+			if (!DistanceMatchingData)
+			{
+				DistanceMatchingData = NewObject<UDistanceMatchingAssetUserData>(AnimSequence, NAME_None, RF_Transactional);
+				AnimSequence->AddAssetUserData(DistanceMatchingData);
+			}
+
+			DistanceMatchingData->Build(Distances[Index], TimeStep, AnimSequence->SequenceLength, DistanceStep);
+			DistanceMatchingData->SourceHash = Hashes[Index];
+
+			if (!bNoSave && !AnimationCommandletUtils::SavePackage(AnimSequence->GetOutermost()))
+			{
+				++NumFailed;
+				continue;
+			}
+
+			UE_LOG(LogTPCAEditor, Verbose, TEXT("DistanceMatching: %s total distance %.2f"), *AnimSequence->GetPathName(), DistanceMatchingData->TotalDistance);
+			++NumUpdated;
+		}
+
+		// Keep memory bounded when processing thousands of animations
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	UE_LOG(LogTPCAEditor, Display, TEXT("DistanceMatching: %d updated, %d up to date, %d failed in %.2fs"), NumUpdated, NumSkipped, NumFailed, FPlatformTime::Seconds() - StartTime);
+
+	return NumFailed > 0 ? 1 : 0;
+}
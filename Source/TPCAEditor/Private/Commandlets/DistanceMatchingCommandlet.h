@@ -0,0 +1,29 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "DistanceMatchingCommandlet.generated.h"
+
+/**
+ * Generates root motion distance tables for animation sequences and stores them as UDistanceMatchingAssetUserData.
+ * Animations are loaded in batches and sampled in parallel. Animations whose source data did not change are skipped.
+ *
+ * Usage:
+ *   UE4Editor-Cmd <Project> -run=DistanceMatching [-Paths=/Game/A+/Game/B] [-SampleRate=30] [-DistanceStep=1] [-BatchSize=256] [-Force] [-NoSave]
+ */
+UCLASS()
+class UDistanceMatchingCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UDistanceMatchingCommandlet();
+
+	//~Begin UCommandlet
+	virtual int32 Main(const FString& Params) override;
+	//~End UCommandlet
+};
@@ -0,0 +1,239 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "Commandlets/FootSyncMarkersCommandlet.h"
+#include "Commandlets/AnimationCommandletUtils.h"
+#include "TPCAEditor.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "Async/ParallelFor.h"
+#include "GameFramework/ExtCharacter.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Parse.h"
+#include "UObject/MetaData.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+static const FName NAME_FootSyncMarkersHash(TEXT("FootSyncMarkersHash"));
+
+struct FFootSyncMarkersResult
+{
+	TArray<float> LeftPlants;
+	TArray<float> RightPlants;
+	double Seconds = 0.0;
+	bool bValid = false;
+};
+
+/** Bones from a foot up to the root, with the animation track of each or INDEX_NONE to use the reference pose. */
+struct FFootBoneChain
+{
+	TArray<int32> BoneIndices;
+	TArray<int32> TrackIndices;
+
+	bool Init(const UAnimSequence* AnimSequence, const FName BoneName)
+	{
+		const USkeleton* Skeleton = AnimSequence->GetSkeleton();
+		const FReferenceSkeleton& RefSkeleton = Skeleton->GetReferenceSkeleton();
+		for (int32 BoneIndex = RefSkeleton.FindBoneIndex(BoneName); BoneIndex != INDEX_NONE; BoneIndex = RefSkeleton.GetParentIndex(BoneIndex))
+		{
+			BoneIndices.Add(BoneIndex);
+			TrackIndices.Add(Skeleton->GetRawAnimationTrackIndex(BoneIndex, AnimSequence));
+		}
+
+		return BoneIndices.Num() > 0;
+	}
+
+	float GetComponentSpaceHeight(const UAnimSequence* AnimSequence, const float Time) const
+	{
+		const TArray<FTransform>& RefPose = AnimSequence->GetSkeleton()->GetReferenceSkeleton().GetRefBonePose();
+
+		FTransform ComponentTransform = FTransform::Identity;
+		for (int32 Index = 0; Index < BoneIndices.Num(); ++Index)
+		{
+			FTransform LocalTransform = RefPose[BoneIndices[Index]];
+			if (TrackIndices[Index] != INDEX_NONE)
+				AnimSequence->GetBoneTransform(LocalTransform, TrackIndices[Index], Time, true);
+
+			ComponentTransform = ComponentTransform * LocalTransform;
+		}
+
+		return ComponentTransform.GetLocation().Z;
+	}
+};
+
+static void FindFootPlants(const UAnimSequence* AnimSequence, const FFootBoneChain& Chain, const float HeightTolerance, TArray<float>& OutPlants)
+{
+	const int32 NumFrames = AnimSequence->GetRawNumberOfFrames();
+	if (NumFrames < 2)
+		return;
+
+	const float FrameTime = AnimSequence->SequenceLength / (NumFrames - 1);
+
+	TArray<float> Heights;
+	Heights.SetNumUninitialized(NumFrames);
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		Heights[Frame] = Chain.GetComponentSpaceHeight(AnimSequence, Frame * FrameTime);
+
+	const float PlantedHeight = FMath::Min(Heights) + HeightTolerance;
+
+	// The last frame matches the first one in loops, so the frame before the first is the one before the last.
+	bool bWasPlanted = Heights[NumFrames - 2] <= PlantedHeight;
+	for (int32 Frame = 0; Frame < NumFrames - 1; ++Frame)
+	{
+		const bool bIsPlanted = Heights[Frame] <= PlantedHeight;
+		if (bIsPlanted && !bWasPlanted)
+			OutPlants.Add(Frame * FrameTime);
+
+		bWasPlanted = bIsPlanted;
+	}
+}
+
+static void ReplaceSyncMarkers(UAnimSequence* AnimSequence, const FName MarkerName, const TArray<float>& Times)
+{
+	AnimSequence->AuthoredSyncMarkers.RemoveAll([MarkerName](const FAnimSyncMarker& Marker) { return Marker.MarkerName == MarkerName; });
+
+	// Markers must belong to a notify track to show up in the editor
+	if (AnimSequence->AnimNotifyTracks.Num() == 0)
+		AnimSequence->AnimNotifyTracks.Add(FAnimNotifyTrack(TEXT("1"), FLinearColor::White));
+
+	for (const float Time : Times)
+	{
+		FAnimSyncMarker& Marker = AnimSequence->AuthoredSyncMarkers.AddDefaulted_GetRef();
+		Marker.MarkerName = MarkerName;
+		Marker.Time = Time;
+		Marker.TrackIndex = 0;
+	}
+}
+
+UFootSyncMarkersCommandlet::UFootSyncMarkersCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UFootSyncMarkersCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	TArray<FString> PackagePaths;
+	AnimationCommandletUtils::ParsePackagePaths(ParamVals, PackagePaths);
+
+	const AExtCharacter* CharacterDefaults = GetDefault<AExtCharacter>();
+	FName LeftFootBoneName = CharacterDefaults->GetLeftFootBoneName();
+	FName RightFootBoneName = CharacterDefaults->GetRightFootBoneName();
+	FName LeftMarkerName(TEXT("L"));
+	FName RightMarkerName(TEXT("R"));
+	float HeightTolerance = 2.f;
+	int32 BatchSize = 256;
+	FParse::Value(*Params, TEXT("LeftFoot="), LeftFootBoneName);
+	FParse::Value(*Params, TEXT("RightFoot="), RightFootBoneName);
+	FParse::Value(*Params, TEXT("LeftMarker="), LeftMarkerName);
+	FParse::Value(*Params, TEXT("RightMarker="), RightMarkerName);
+	FParse::Value(*Params, TEXT("HeightTolerance="), HeightTolerance);
+	FParse::Value(*Params, TEXT("BatchSize="), BatchSize);
+	const bool bForce = Switches.Contains(TEXT("Force"));
+	const bool bNoSave = Switches.Contains(TEXT("NoSave"));
+
+	if (BatchSize <= 0)
+	{
+		UE_LOG(LogTPCAEditor, Error, TEXT("BatchSize must be greater than zero."));
+		return 1;
+	}
+
+	const FString Settings = FString::Printf(TEXT("%s;%s;%s;%s;%g"), *LeftFootBoneName.ToString(), *RightFootBoneName.ToString(), *LeftMarkerName.ToString(), *RightMarkerName.ToString(), HeightTolerance);
+
+	TArray<FAssetData> Assets;
+	AnimationCommandletUtils::GatherAnimSequences(PackagePaths, Assets);
+	UE_LOG(LogTPCAEditor, Display, TEXT("FootSyncMarkers: found %d animation sequences in %s"), Assets.Num(), *FString::Join(PackagePaths, TEXT(", ")));
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 NumUpdated = 0;
+	int32 NumSkipped = 0;
+	int32 NumFailed = 0;
+
+	for (int32 BatchStart = 0; BatchStart < Assets.Num(); BatchStart += BatchSize)
+	{
+		const int32 BatchEnd = FMath::Min(BatchStart + BatchSize, Assets.Num());
+
+		TArray<UAnimSequence*> Batch;
+		TArray<FString> Hashes;
+		for (int32 AssetIndex = BatchStart; AssetIndex < BatchEnd; ++AssetIndex)
+		{
+			UAnimSequence* AnimSequence = Cast<UAnimSequence>(Assets[AssetIndex].GetAsset());
+			if (!AnimSequence || !AnimSequence->GetSkeleton())
+			{
+				UE_LOG(LogTPCAEditor, Warning, TEXT("FootSyncMarkers: could not load %s"), *Assets[AssetIndex].ObjectPath.ToString());
+				++NumFailed;
+				continue;
+			}
+
+			const FString Hash = AnimationCommandletUtils::GetSourceHash(AnimSequence, Settings);
+			if (!bForce && AnimSequence->GetOutermost()->GetMetaData()->GetValue(AnimSequence, NAME_FootSyncMarkersHash) == Hash)
+			{
+				++NumSkipped;
+				continue;
+			}
+
+			Batch.Add(AnimSequence);
+			Hashes.Add(Hash);
+		}
+
+		TArray<FFootSyncMarkersResult> Results;
+		Results.SetNum(Batch.Num());
+		ParallelFor(Batch.Num(), [&Batch, &Results, LeftFootBoneName, RightFootBoneName, HeightTolerance](int32 Index)
+		{
+			const double AssetStartTime = FPlatformTime::Seconds();
+			const UAnimSequence* AnimSequence = Batch[Index];
+			FFootSyncMarkersResult& Result = Results[Index];
+
+			FFootBoneChain LeftChain;
+			FFootBoneChain RightChain;
+			Result.bValid = LeftChain.Init(AnimSequence, LeftFootBoneName) && RightChain.Init(AnimSequence, RightFootBoneName);
+			if (Result.bValid)
+			{
+				FindFootPlants(AnimSequence, LeftChain, HeightTolerance, Result.LeftPlants);
+				FindFootPlants(AnimSequence, RightChain, HeightTolerance, Result.RightPlants);
+			}
+
+			Result.Seconds = FPlatformTime::Seconds() - AssetStartTime;
+		});
+
+		for (int32 Index = 0; Index < Batch.Num(); ++Index)
+		{
+			UAnimSequence* AnimSequence = Batch[Index];
+			const FFootSyncMarkersResult& Result = Results[Index];
+			if (!Result.bValid)
+			{
+				UE_LOG(LogTPCAEditor, Warning, TEXT("FootSyncMarkers: %s has no %s or %s bone"), *AnimSequence->GetPathName(), *LeftFootBoneName.ToString(), *RightFootBoneName.ToString());
+				++NumFailed;
+				continue;
+			}
+
+			AnimSequence->Modify();
+			ReplaceSyncMarkers(AnimSequence, LeftMarkerName, Result.LeftPlants);
+			ReplaceSyncMarkers(AnimSequence, RightMarkerName, Result.RightPlants);
+			AnimSequence->RefreshSyncMarkerDataFromAuthored();
+			AnimSequence->GetOutermost()->GetMetaData()->SetValue(AnimSequence, NAME_FootSyncMarkersHash, *Hashes[Index]);
+
+			if (!bNoSave && !AnimationCommandletUtils::SavePackage(AnimSequence->GetOutermost()))
+			{
+				++NumFailed;
+				continue;
+			}
+
+			UE_LOG(LogTPCAEditor, Display, TEXT("FootSyncMarkers: %s %d left, %d right in %.2fms"), *AnimSequence->GetPathName(), Result.LeftPlants.Num(), Result.RightPlants.Num(), Result.Seconds * 1000.0);
+			++NumUpdated;
+		}
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	UE_LOG(LogTPCAEditor, Display, TEXT("FootSyncMarkers: %d updated, %d up to date, %d failed in %.2fs"), NumUpdated, NumSkipped, NumFailed, FPlatformTime::Seconds() - StartTime);
+
+	return NumFailed > 0 ? 1 : 0;
+}
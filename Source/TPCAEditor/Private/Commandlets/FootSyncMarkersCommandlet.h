@@ -0,0 +1,32 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "FootSyncMarkersCommandlet.generated.h"
+
+/**
+ * Detects foot plants in animation sequences and writes a sync marker for each one.
+ * A foot is planted when its component space height is within HeightTolerance of its lowest point in the animation; a marker is added on the frame
+ * the foot lands. Foot bone names default to the ones configured in AExtCharacter. Animations are sampled in parallel and those whose source data
+ * and settings did not change since the last run are skipped.
+ *
+ * Usage:
+ *   UE4Editor-Cmd <Project> -run=FootSyncMarkers [-Paths=/Game/A+/Game/B] [-LeftFoot=foot_l] [-RightFoot=foot_r] [-LeftMarker=L] [-RightMarker=R]
+ *                 [-HeightTolerance=2] [-BatchSize=256] [-Force] [-NoSave]
+ */
+UCLASS()
+class UFootSyncMarkersCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UFootSyncMarkersCommandlet();
+
+	//~Begin UCommandlet
+	virtual int32 Main(const FString& Params) override;
+	//~End UCommandlet
+};
@@ -0,0 +1,190 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "Commandlets/NetBenchmarkCommandlet.h"
+#include "TPCAEditor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+
+/** Key,Value lines written by UNetBenchmarkSubsystem. */
+static bool LoadReport(const FString& Path, TMap<FString, float>& OutValues)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+		return false;
+
+	for (const FString& Line : Lines)
+	{
+		FString Key;
+		FString Value;
+		if (Line.Split(TEXT(","), &Key, &Value) && Value.IsNumeric())
+			OutValues.Add(Key, FCString::Atof(*Value));
+	}
+
+	return true;
+}
+
+static FProcHandle LaunchProcess(const FString& Args, const FString& Name)
+{
+	UE_LOG(LogTPCAEditor, Display, TEXT("NetBenchmark: starting %s"), *Name);
+	UE_LOG(LogTPCAEditor, Verbose, TEXT("NetBenchmark: %s %s"), FPlatformProcess::ExecutablePath(), *Args);
+
+	FProcHandle Handle = FPlatformProcess::CreateProc(FPlatformProcess::ExecutablePath(), *Args, false, true, true, nullptr, 0, nullptr, nullptr);
+	if (!Handle.IsValid())
+		UE_LOG(LogTPCAEditor, Error, TEXT("NetBenchmark: could not start %s"), *Name);
+
+	return Handle;
+}
+
+UNetBenchmarkCommandlet::UNetBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+int32 UNetBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	FString Map;
+	FString OutputDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("NetBenchmark"), FDateTime::Now().ToString());
+	int32 NumClients = 8;
+	int32 Port = 17777;
+	float Duration = 60.f;
+	float Warmup = 10.f;
+	float PktLag = 0.f;
+	float PktLagVariance = 0.f;
+	float PktLoss = 0.f;
+	FParse::Value(*Params, TEXT("Map="), Map);
+	FParse::Value(*Params, TEXT("Output="), OutputDir);
+	FParse::Value(*Params, TEXT("Clients="), NumClients);
+	FParse::Value(*Params, TEXT("Port="), Port);
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("Warmup="), Warmup);
+	FParse::Value(*Params, TEXT("PktLag="), PktLag);
+	FParse::Value(*Params, TEXT("PktLagVariance="), PktLagVariance);
+	FParse::Value(*Params, TEXT("PktLoss="), PktLoss);
+	const bool bListen = Switches.Contains(TEXT("Listen"));
+
+	if (Map.IsEmpty())
+	{
+		UE_LOG(LogTPCAEditor, Error, TEXT("NetBenchmark: -Map is required."));
+		return 1;
+	}
+
+	if (NumClients <= 0 || Duration <= 0.f)
+	{
+		UE_LOG(LogTPCAEditor, Error, TEXT("NetBenchmark: Clients and Duration must be greater than zero."));
+		return 1;
+	}
+
+	OutputDir = FPaths::ConvertRelativePathToFull(OutputDir);
+	IFileManager::Get().MakeDirectory(*OutputDir, true);
+
+	const FString ProjectFile = FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath());
+	const FString CommonArgs = FString::Printf(TEXT("-nullrhi -nosound -unattended -nosplash -NetBenchmark -BenchmarkDuration=%g -PktLag=%g -PktLagVariance=%g -PktLoss=%g"),
+		Duration, PktLag, PktLagVariance, PktLoss);
+
+	// The server samples from the end of its warmup and clients from the end of theirs, so they overlap once every client has joined
+	TArray<FProcHandle> Processes;
+	TArray<FString> ReportPaths;
+
+	const FString ServerReport = FPaths::Combine(OutputDir, TEXT("Server.csv"));
+	const FString ServerArgs = bListen
+		? FString::Printf(TEXT("\"%s\" %s?listen -game -port=%d %s -BenchmarkWarmup=%g -BenchmarkReport=\"%s\" -abslog=\"%s\""),
+			*ProjectFile, *Map, Port, *CommonArgs, Warmup, *ServerReport, *FPaths::Combine(OutputDir, TEXT("Server.log")))
+		: FString::Printf(TEXT("\"%s\" %s -server -port=%d %s -BenchmarkWarmup=%g -BenchmarkReport=\"%s\" -abslog=\"%s\""),
+			*ProjectFile, *Map, Port, *CommonArgs, Warmup, *ServerReport, *FPaths::Combine(OutputDir, TEXT("Server.log")));
+	Processes.Add(LaunchProcess(ServerArgs, TEXT("server")));
+	ReportPaths.Add(ServerReport);
+
+	// Give the server time to load the map before clients try to connect
+	FPlatformProcess::Sleep(FMath::Min(Warmup * 0.5f, 10.f));
+
+	for (int32 ClientIndex = 0; ClientIndex < NumClients; ++ClientIndex)
+	{
+		const FString ClientReport = FPaths::Combine(OutputDir, FString::Printf(TEXT("Client%d.csv"), ClientIndex));
+		const FString ClientArgs = FString::Printf(TEXT("\"%s\" 127.0.0.1:%d -game %s -BenchmarkClient=%d -BenchmarkWarmup=%g -BenchmarkReport=\"%s\" -abslog=\"%s\""),
+			*ProjectFile, Port, *CommonArgs, ClientIndex, Warmup, *ClientReport, *FPaths::Combine(OutputDir, FString::Printf(TEXT("Client%d.log"), ClientIndex)));
+		Processes.Add(LaunchProcess(ClientArgs, FString::Printf(TEXT("client %d"), ClientIndex)));
+		ReportPaths.Add(ClientReport);
+	}
+
+	// Clients may take a while to join so allow for a full extra warmup and some slack before giving up
+	const double Deadline = FPlatformTime::Seconds() + Warmup * 2.0 + Duration + 60.0;
+	for (FProcHandle& Process : Processes)
+	{
+		while (Process.IsValid() && FPlatformProcess::IsProcRunning(Process) && FPlatformTime::Seconds() < Deadline)
+			FPlatformProcess::Sleep(0.5f);
+
+		if (Process.IsValid() && FPlatformProcess::IsProcRunning(Process))
+		{
+			UE_LOG(LogTPCAEditor, Warning, TEXT("NetBenchmark: process did not finish in time, terminating it"));
+			FPlatformProcess::TerminateProc(Process, true);
+		}
+
+		FPlatformProcess::CloseProc(Process);
+	}
+
+	TMap<FString, float> ServerValues;
+	if (!LoadReport(ServerReport, ServerValues))
+	{
+		UE_LOG(LogTPCAEditor, Error, TEXT("NetBenchmark: server did not write a report, see %s"), *FPaths::Combine(OutputDir, TEXT("Server.log")));
+		return 1;
+	}
+
+	// Averages over the clients that finished
+	const TCHAR* ClientKeys[] = { TEXT("CorrectionsPerSecond"), TEXT("MovesReplayedPerSecond"), TEXT("Proxies"), TEXT("ProxyMsPerFrame"),
+		TEXT("ProxyUsPerProxyFrame"), TEXT("InBytesPerSecondPerConnection"), TEXT("OutBytesPerSecondPerConnection"), TEXT("CpuMsPerFrame") };
+	TMap<FString, float> ClientAverages;
+	int32 NumReports = 0;
+	for (int32 Index = 1; Index < ReportPaths.Num(); ++Index)
+	{
+		TMap<FString, float> ClientValues;
+		if (!LoadReport(ReportPaths[Index], ClientValues))
+		{
+			UE_LOG(LogTPCAEditor, Warning, TEXT("NetBenchmark: client %d did not write a report"), Index - 1);
+			continue;
+		}
+
+		for (const TCHAR* Key : ClientKeys)
+			ClientAverages.FindOrAdd(Key) += ClientValues.FindRef(Key);
+
+		++NumReports;
+	}
+
+	for (TPair<FString, float>& Pair : ClientAverages)
+		Pair.Value /= FMath::Max(NumReports, 1);
+
+	TArray<FString> Summary;
+	Summary.Add(FString::Printf(TEXT("Clients,%d"), NumReports));
+	Summary.Add(FString::Printf(TEXT("PktLag,%g"), PktLag));
+	Summary.Add(FString::Printf(TEXT("PktLagVariance,%g"), PktLagVariance));
+	Summary.Add(FString::Printf(TEXT("PktLoss,%g"), PktLoss));
+	for (const TPair<FString, float>& Pair : ServerValues)
+		Summary.Add(FString::Printf(TEXT("Server%s,%g"), *Pair.Key, Pair.Value));
+	for (const TPair<FString, float>& Pair : ClientAverages)
+		Summary.Add(FString::Printf(TEXT("Client%s,%g"), *Pair.Key, Pair.Value));
+	FFileHelper::SaveStringArrayToFile(Summary, *FPaths::Combine(OutputDir, TEXT("Summary.csv")));
+
+	UE_LOG(LogTPCAEditor, Display, TEXT("NetBenchmark: %d of %d clients reported, results in %s"), NumReports, NumClients, *OutputDir);
+	UE_LOG(LogTPCAEditor, Display, TEXT("  Server CPU: %.3f ms/frame, %.4f ms/player/frame for %.1f players"),
+		ServerValues.FindRef(TEXT("CpuMsPerFrame")), ServerValues.FindRef(TEXT("CpuMsPerPlayer")), ServerValues.FindRef(TEXT("Players")));
+	UE_LOG(LogTPCAEditor, Display, TEXT("  Server bandwidth per connection: %.0f B/s out, %.0f B/s in"),
+		ServerValues.FindRef(TEXT("OutBytesPerSecondPerConnection")), ServerValues.FindRef(TEXT("InBytesPerSecondPerConnection")));
+	UE_LOG(LogTPCAEditor, Display, TEXT("  Client corrections: %.3f/s, %.2f moves replayed/s"),
+		ClientAverages.FindRef(TEXT("CorrectionsPerSecond")), ClientAverages.FindRef(TEXT("MovesReplayedPerSecond")));
+	UE_LOG(LogTPCAEditor, Display, TEXT("  Client proxy simulation and smoothing: %.4f ms/frame for %.1f proxies, %.3f us/proxy/frame"),
+		ClientAverages.FindRef(TEXT("ProxyMsPerFrame")), ClientAverages.FindRef(TEXT("Proxies")), ClientAverages.FindRef(TEXT("ProxyUsPerProxyFrame")));
+
+	return NumReports == NumClients ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "NetBenchmarkCommandlet.generated.h"
+
+/**
+ * Measures the network cost of ExtCharacters by running a server and a number of clients as local headless processes connected over
+ * loopback. Every process runs with -nullrhi and -NetBenchmark so UNetBenchmarkSubsystem drives the clients with scripted input and
+ * writes a report; this commandlet waits for them and logs a summary. The map must spawn an ExtCharacter for every player.
+ * Lag, lag variance (jitter) and loss are applied by the engine packet simulation of every process to its outgoing packets.
+ *
+ * Usage:
+ *   UE4Editor-Cmd <Project> -run=NetBenchmark -Map=/Game/Maps/Arena [-Clients=8] [-Duration=60] [-Warmup=10] [-Port=17777] [-Listen]
+ *                 [-PktLag=50] [-PktLagVariance=10] [-PktLoss=1] [-Output=<Dir>]
+ */
+UCLASS()
+class UNetBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UNetBenchmarkCommandlet();
+
+	//~Begin UCommandlet
+	virtual int32 Main(const FString& Params) override;
+	//~End UCommandlet
+};
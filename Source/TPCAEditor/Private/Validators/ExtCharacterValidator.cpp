@@ -0,0 +1,183 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#include "Validators/ExtCharacterValidator.h"
+#include "Animation/AnimBlueprint.h"
+#include "Animation/ExtCharacterAnimInstance.h"
+#include "AnimGraphNode_Base.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/Blueprint.h"
+#include "Engine/SkeletalMesh.h"
+#include "GameFramework/ExtCharacter.h"
+#include "GameFramework/ExtCharacterMovementComponent.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+
+#define LOCTEXT_NAMESPACE "ExtCharacterValidator"
+
+UExtCharacterValidator::UExtCharacterValidator()
+{
+	bIsEnabled = true;
+	bReportCostsAsErrors = false;
+	NumIssues = 0;
+}
+
+bool UExtCharacterValidator::CanValidateAsset_Implementation(UObject* InAsset) const
+{
+	if (const UBlueprint* Blueprint = Cast<UBlueprint>(InAsset))
+	{
+		if (const UClass* GeneratedClass = Blueprint->GeneratedClass)
+			return GeneratedClass->IsChildOf(AExtCharacter::StaticClass()) || GeneratedClass->IsChildOf(UExtCharacterAnimInstance::StaticClass());
+	}
+
+	return false;
+}
+
+EDataValidationResult UExtCharacterValidator::ValidateLoadedAsset_Implementation(UObject* InAsset, TArray<FText>& ValidationErrors)
+{
+	NumIssues = 0;
+
+	const UBlueprint* Blueprint = CastChecked<UBlueprint>(InAsset);
+	const UObject* Defaults = Blueprint->GeneratedClass->GetDefaultObject();
+
+	if (const AExtCharacter* Character = Cast<AExtCharacter>(Defaults))
+		ValidateCharacter(InAsset, Character, ValidationErrors);
+	else if (const UExtCharacterAnimInstance* AnimInstance = Cast<UExtCharacterAnimInstance>(Defaults))
+		ValidateAnimInstance(InAsset, Cast<UAnimBlueprint>(Blueprint), AnimInstance, ValidationErrors);
+
+	if (NumIssues > 0 && bReportCostsAsErrors)
+		return EDataValidationResult::Invalid;
+
+	AssetPasses(InAsset);
+	return EDataValidationResult::Valid;
+}
+
+void UExtCharacterValidator::ValidateCharacter(UObject* InAsset, const AExtCharacter* Character, TArray<FText>& ValidationErrors)
+{
+	// Player pawns spawned by the game mode keep the default possession settings, so only characters explicitly set up to be possessed by AI
+	// when spawned count as AI. The default PlacedInWorld does not say anything about how the character is used.
+	const bool bIsSpawnedAI = Character->AIControllerClass
+		&& Character->AutoPossessPlayer == EAutoReceiveInput::Disabled
+		&& (Character->AutoPossessAI == EAutoPossessAI::Spawned || Character->AutoPossessAI == EAutoPossessAI::PlacedInWorldOrSpawned);
+
+	if (Character->bEnableFootIK && bIsSpawnedAI)
+	{
+		ReportCost(InAsset,
+			LOCTEXT("FootIKOnAI", "Foot IK is enabled on a character that is possessed by AI when spawned. Consider disabling bEnableFootIK for background AI."),
+			LOCTEXT("FootIKOnAICost", "2 foot traces and 2 IK solves per character per frame (~0.02-0.05ms game + worker thread each)"),
+			ValidationErrors);
+	}
+
+	if (const UExtCharacterMovementComponent* Movement = Character->GetExtCharacterMovement())
+	{
+		if (Movement->bPushAwayFromPawns)
+		{
+			ReportCost(InAsset,
+				LOCTEXT("PushAway", "Push away from pawns is enabled. Disable bPushAwayFromPawns if this character is not expected to get close to other pawns."),
+				LOCTEXT("PushAwayCost", "1 capsule overlap query per character per movement update (~0.01-0.03ms, grows with the number of nearby pawns)"),
+				ValidationErrors);
+		}
+	}
+
+	const FRepExtMovement& ExtMovement = Character->ReplicatedExtMovement;
+	if (ExtMovement.LocationQuantizationLevel != EVectorQuantization::RoundWholeNumber || ExtMovement.VelocityQuantizationLevel != EVectorQuantization::RoundWholeNumber)
+	{
+		ReportCost(InAsset,
+			LOCTEXT("VectorQuantization", "ReplicatedExtMovement uses more than whole number precision for location or velocity."),
+			LOCTEXT("VectorQuantizationCost", "up to 18 extra bits per vector per replicated update to every relevant connection"),
+			ValidationErrors);
+	}
+
+	if (ExtMovement.RotationQuantizationLevel == ERotatorQuantization::ShortComponents)
+	{
+		ReportCost(InAsset,
+			LOCTEXT("RotationQuantization", "ReplicatedExtMovement uses short components for rotation."),
+			LOCTEXT("RotationQuantizationCost", "up to 24 extra bits per replicated update to every relevant connection"),
+			ValidationErrors);
+	}
+
+	if (const UCapsuleComponent* Capsule = Character->GetCapsuleComponent())
+	{
+		if (Capsule->GetGenerateOverlapEvents())
+		{
+			ReportCost(InAsset,
+				LOCTEXT("CapsuleOverlaps", "The capsule generates overlap events. Disable them unless gameplay depends on capsule overlaps."),
+				LOCTEXT("CapsuleOverlapsCost", "1 overlap update per capsule move plus begin/end overlap dispatch (~0.01-0.1ms per move)"),
+				ValidationErrors);
+		}
+	}
+
+	if (const USkeletalMeshComponent* Mesh = Character->GetMesh())
+	{
+		if (Mesh->SkeletalMesh && Mesh->SkeletalMesh->GetLODNum() <= 1)
+		{
+			ReportCost(InAsset,
+				FText::Format(LOCTEXT("NoLODs", "Skeletal mesh {0} has no LODs."), FText::FromString(Mesh->SkeletalMesh->GetName())),
+				LOCTEXT("NoLODsCost", "full vertex skinning and bone count at any distance (GPU skinning and render thread cost do not scale down)"),
+				ValidationErrors);
+		}
+
+		if (Mesh->VisibilityBasedAnimTickOption == EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones)
+		{
+			ReportCost(InAsset,
+				LOCTEXT("AlwaysTickPose", "The mesh always ticks its pose and refreshes bones even when not rendered."),
+				LOCTEXT("AlwaysTickPoseCost", "full animation evaluation for off-screen characters (~0.05-0.2ms per character per frame)"),
+				ValidationErrors);
+		}
+
+		if (Mesh->GetGenerateOverlapEvents())
+		{
+			ReportCost(InAsset,
+				LOCTEXT("MeshOverlaps", "The skeletal mesh generates overlap events."),
+				LOCTEXT("MeshOverlapsCost", "1 overlap update per physics body per move (scales with the number of bodies in the physics asset)"),
+				ValidationErrors);
+		}
+	}
+}
+
+void UExtCharacterValidator::ValidateAnimInstance(UObject* InAsset, const UAnimBlueprint* AnimBlueprint, const UExtCharacterAnimInstance* AnimInstance, TArray<FText>& ValidationErrors)
+{
+	if (!AnimBlueprint)
+		return;
+
+	// Native update already gathers the character state so any event graph logic is additional game thread cost.
+	const UFunction* UpdateFunction = AnimBlueprint->GeneratedClass->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UAnimInstance, BlueprintUpdateAnimation));
+	if (UpdateFunction && UpdateFunction->GetOwnerClass()->ClassGeneratedBy)
+	{
+		ReportCost(InAsset,
+			LOCTEXT("BlueprintUpdate", "The event graph implements Blueprint Update Animation. State is already gathered natively by UExtCharacterAnimInstance."),
+			LOCTEXT("BlueprintUpdateCost", "blueprint VM execution on the game thread per instance per frame (~0.01-0.1ms depending on graph size)"),
+			ValidationErrors);
+	}
+
+	// Blueprint usage of each node is determined when the anim blueprint is compiled
+	TArray<UAnimGraphNode_Base*> AnimNodes;
+	FBlueprintEditorUtils::GetAllNodesOfClass<UAnimGraphNode_Base>(AnimBlueprint, AnimNodes);
+	for (const UAnimGraphNode_Base* AnimNode : AnimNodes)
+	{
+		if (AnimNode->BlueprintUsage == EBlueprintUsage::UsesBlueprint)
+		{
+			ReportCost(InAsset,
+				FText::Format(LOCTEXT("FastPath", "{0} in {1} has pin bindings that leave the fast path."),
+					AnimNode->GetNodeTitle(ENodeTitleType::ListView), FText::FromString(GetNameSafe(AnimNode->GetGraph()))),
+				LOCTEXT("FastPathCost", "blueprint VM execution on the worker thread per node per update (~0.005-0.02ms each)"),
+				ValidationErrors);
+		}
+	}
+}
+
+void UExtCharacterValidator::ReportCost(UObject* InAsset, const FText& Message, const FText& Cost, TArray<FText>& ValidationErrors)
+{
+	++NumIssues;
+
+	const FText FullMessage = FText::Format(LOCTEXT("CostFormat", "{0} Estimated cost: {1}."), Message, Cost);
+	if (bReportCostsAsErrors)
+	{
+		AssetFails(InAsset, FullMessage, ValidationErrors);
+	}
+	else
+	{
+		AssetWarning(InAsset, FullMessage);
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
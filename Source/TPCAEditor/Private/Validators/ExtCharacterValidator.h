@@ -0,0 +1,49 @@
+// This source code is licensed under the MIT license found in the LICENSE file in the root directory of this source tree.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EditorValidatorBase.h"
+
+#include "ExtCharacterValidator.generated.h"
+
+class AExtCharacter;
+class UExtCharacterAnimInstance;
+class UAnimBlueprint;
+
+/**
+ * Flags ExtCharacter and ExtCharacterAnimInstance blueprints with settings that are known to be expensive at runtime, along with an estimate
+ * of their cost. Runs in the editor on save and from the DataValidation commandlet (-run=DataValidation).
+ *
+ * Issues are reported as warnings unless bReportCostsAsErrors is set in the [/Script/TPCAEditor.ExtCharacterValidator] section of
+ * DefaultEditor.ini, in which case they fail validation and can be used to block check-ins.
+ */
+UCLASS(Config = Editor)
+class UExtCharacterValidator : public UEditorValidatorBase
+{
+	GENERATED_BODY()
+
+public:
+
+	UExtCharacterValidator();
+
+	/** If true report expensive settings as errors instead of warnings. */
+	UPROPERTY(Config)
+	bool bReportCostsAsErrors;
+
+protected:
+
+	//~Begin UEditorValidatorBase
+	virtual bool CanValidateAsset_Implementation(UObject* InAsset) const override;
+	virtual EDataValidationResult ValidateLoadedAsset_Implementation(UObject* InAsset, TArray<FText>& ValidationErrors) override;
+	//~End UEditorValidatorBase
+
+	void ValidateCharacter(UObject* InAsset, const AExtCharacter* Character, TArray<FText>& ValidationErrors);
+	void ValidateAnimInstance(UObject* InAsset, const UAnimBlueprint* AnimBlueprint, const UExtCharacterAnimInstance* AnimInstance, TArray<FText>& ValidationErrors);
+
+private:
+
+	int32 NumIssues;
+
+	void ReportCost(UObject* InAsset, const FText& Message, const FText& Cost, TArray<FText>& ValidationErrors);
+};
@@ -28,6 +28,9 @@ public TPCAEditor(ReadOnlyTargetRules Target) : base(Target)
 		PrivateDependencyModuleNames.AddRange(
 			new string[]
 			{
+				"AnimGraph",
+				"AssetRegistry",
+				"DataValidation",
 				"Slate",
 				"SlateCore",
 				"EditorStyle",